@@ -0,0 +1,248 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <cstddef>
+#include <new>
+#include "memory.h"
+
+/* Node allocators for BasicList<T, Alloc>. An allocator hands out raw memory for
+ * one node at a time, and is owned by its List (it moves along with the
+ * nodes, and is never copied):
+ *
+ *   allocate<Node>()    - memory for one Node
+ *   deallocate(node)    - gives one Node back
+ *   BULK_RELEASE        - whether releaseAll() frees every node at once
+ *   releaseAll()        - frees every node handed out so far
+ */
+
+//one 'new' and one 'delete' per node, the default
+struct HeapNodes{
+	static constexpr bool BULK_RELEASE = false;
+	template <typename Node>
+	Node* allocate(){
+		return static_cast<Node*>(memoryNew(MEMORY_HEAP_NODES, sizeof(Node)));
+	}
+	template <typename Node>
+	void deallocate(Node *node) noexcept{
+		memoryDelete(MEMORY_HEAP_NODES, node, sizeof(Node));
+	}
+	void releaseAll() noexcept{}
+};
+
+/* One 'new' per node like HeapNodes, but the nodes a thread gives back are
+ * kept on that thread's own free list (up to CACHED_NODES of each size) for
+ * its next allocations, so threads building numbers at the same time seldom
+ * reach the global allocator and its locks. A node may be given back by
+ * another thread than the one it came from. The free lists are freed as
+ * their threads exit. A MemoryBudget is charged for a node whenever it is
+ * handed out and credited whenever it is given back, whether it comes from
+ * or goes to a free list or the global allocator.
+ */
+class ThreadNodes{
+  public:
+	static constexpr bool BULK_RELEASE = false;
+	static constexpr size_t CACHED_NODES = 4096;
+	template <typename Node>
+	Node* allocate();
+	template <typename Node>
+	void deallocate(Node *node) noexcept;
+	void releaseAll() noexcept{}
+
+  private:
+	struct Cache{
+		void *freeList; //nodes given back, linked through their first bytes
+		size_t count;
+		size_t slot; //bytes of a node
+		~Cache();
+	};
+	template <size_t SLOT>
+	static Cache& cache() noexcept;
+	template <typename Node>
+	static constexpr size_t slotSize() noexcept;
+};
+
+/* Hands nodes out of contiguous chunks, each twice as large as the last
+ * (up to MAX_CHUNK_NODES nodes), so building a number costs a handful of
+ * allocations and neighbouring limbs end up next to each other. Nodes that
+ * are given back are reused, and releaseAll() drops every node in one go,
+ * keeping only the newest chunk for the nodes that follow. An arena serves
+ * a single node type.
+ */
+class ArenaNodes{
+  public:
+	static constexpr bool BULK_RELEASE = true;
+	static constexpr size_t FIRST_CHUNK_NODES = 32;
+	static constexpr size_t MAX_CHUNK_NODES = 65536;
+	ArenaNodes() noexcept;
+	ArenaNodes(ArenaNodes &&other) noexcept;
+	ArenaNodes(const ArenaNodes&) = delete;
+	~ArenaNodes();
+	ArenaNodes& operator=(ArenaNodes &&other) noexcept;
+	ArenaNodes& operator=(const ArenaNodes&) = delete;
+	template <typename Node>
+	Node* allocate();
+	template <typename Node>
+	void deallocate(Node *node) noexcept;
+	void releaseAll() noexcept;
+
+  private:
+	struct Chunk{
+		Chunk *next; //older chunk
+		size_t bytes; //the header included
+	};
+	static constexpr size_t HEADER = (sizeof(Chunk) + alignof(max_align_t) - 1) / alignof(max_align_t) * alignof(max_align_t);
+	Chunk *chunks; //newest first
+	char *cursor; //first unused byte of the newest chunk
+	char *limit; //end of the newest chunk
+	void *freeList; //nodes given back, linked through their first bytes
+	size_t nextNodes; //nodes in the next chunk
+	void grow(size_t slot);
+	static void freeChunks(Chunk *chunk) noexcept;
+	template <typename Node>
+	static constexpr size_t slotSize() noexcept;
+};
+
+///////////////////////// PRIVATE METHODS ////////////////////////////////
+
+//a slot holds a Node, or the link of a freed one, and keeps the next slot aligned
+template <typename Node>
+constexpr size_t ArenaNodes::slotSize() noexcept{
+	return ((sizeof(Node) > sizeof(void*)? sizeof(Node): sizeof(void*)) + alignof(max_align_t) - 1)
+		   / alignof(max_align_t) * alignof(max_align_t);
+}
+
+inline void ArenaNodes::grow(size_t slot){
+	size_t bytes = HEADER + nextNodes * slot;
+	Chunk *chunk = static_cast<Chunk*>(memoryNew(MEMORY_ARENA_NODES, bytes));
+	chunk->next = chunks;
+	chunk->bytes = bytes;
+	chunks = chunk;
+	cursor = reinterpret_cast<char*>(chunk) + HEADER;
+	limit = cursor + nextNodes * slot;
+	if(nextNodes < MAX_CHUNK_NODES)
+		nextNodes *= 2;
+}
+
+inline void ArenaNodes::freeChunks(Chunk *chunk) noexcept{
+	while(chunk != nullptr){
+		Chunk *older = chunk->next;
+		memoryDelete(MEMORY_ARENA_NODES, chunk, chunk->bytes);
+		chunk = older;
+	}
+}
+
+///////////////////////// PUBLIC METHODS ////////////////////////////////
+
+inline ArenaNodes::ArenaNodes() noexcept
+	:chunks{nullptr},cursor{nullptr},limit{nullptr},freeList{nullptr},nextNodes{FIRST_CHUNK_NODES}{}
+
+//move constructor, 'other' is left without any chunks
+inline ArenaNodes::ArenaNodes(ArenaNodes &&other) noexcept
+	:chunks{other.chunks},cursor{other.cursor},limit{other.limit},freeList{other.freeList},nextNodes{other.nextNodes}{
+	other.chunks = nullptr;
+	other.cursor = other.limit = nullptr;
+	other.freeList = nullptr;
+	other.nextNodes = FIRST_CHUNK_NODES;
+}
+
+inline ArenaNodes::~ArenaNodes(){
+	freeChunks(chunks);
+}
+
+inline ArenaNodes& ArenaNodes::operator=(ArenaNodes &&other) noexcept{
+	if(&other != this){
+		freeChunks(chunks);
+		chunks = other.chunks;
+		cursor = other.cursor;
+		limit = other.limit;
+		freeList = other.freeList;
+		nextNodes = other.nextNodes;
+		other.chunks = nullptr;
+		other.cursor = other.limit = nullptr;
+		other.freeList = nullptr;
+		other.nextNodes = FIRST_CHUNK_NODES;
+	}
+	return *this;
+}
+
+template <typename Node>
+Node* ArenaNodes::allocate(){
+	if(freeList != nullptr){
+		void *slot = freeList;
+		freeList = *static_cast<void**>(slot);
+		return static_cast<Node*>(slot);
+	}
+	if(static_cast<size_t>(limit - cursor) < slotSize<Node>())
+		grow(slotSize<Node>());
+	Node *node = reinterpret_cast<Node*>(cursor);
+	cursor += slotSize<Node>();
+	return node;
+}
+
+template <typename Node>
+void ArenaNodes::deallocate(Node *node) noexcept{
+	*reinterpret_cast<void**>(node) = freeList;
+	freeList = node;
+}
+
+inline void ArenaNodes::releaseAll() noexcept{
+	if(chunks == nullptr)
+		return;
+	freeChunks(chunks->next);
+	chunks->next = nullptr;
+	cursor = reinterpret_cast<char*>(chunks) + HEADER;
+	freeList = nullptr;
+}
+
+///////////////////////// THREAD NODES ////////////////////////////////
+
+//nodes given back after this, while the thread exits, go straight to 'delete'
+inline ThreadNodes::Cache::~Cache(){
+	MemoryBudgetScope none(nullptr); //the nodes were credited when they were given back
+	while(freeList != nullptr){
+		void *next = *static_cast<void**>(freeList);
+		memoryDelete(MEMORY_THREAD_NODES, freeList, slot);
+		freeList = next;
+	}
+	count = CACHED_NODES;
+}
+
+//the calling thread's free list of SLOT byte nodes
+template <size_t SLOT>
+ThreadNodes::Cache& ThreadNodes::cache() noexcept{
+	static thread_local Cache nodes = {nullptr, 0, SLOT};
+	return nodes;
+}
+
+//a slot holds a Node, or the link of a freed one
+template <typename Node>
+constexpr size_t ThreadNodes::slotSize() noexcept{
+	return (sizeof(Node) > sizeof(void*)? sizeof(Node): sizeof(void*));
+}
+
+template <typename Node>
+Node* ThreadNodes::allocate(){
+	Cache &nodes = cache<slotSize<Node>()>();
+	if(nodes.freeList == nullptr)
+		return static_cast<Node*>(memoryNew(MEMORY_THREAD_NODES, slotSize<Node>()));
+	memoryBudgetCharge(slotSize<Node>());
+	void *slot = nodes.freeList;
+	nodes.freeList = *static_cast<void**>(slot);
+	--nodes.count;
+	return static_cast<Node*>(slot);
+}
+
+template <typename Node>
+void ThreadNodes::deallocate(Node *node) noexcept{
+	Cache &nodes = cache<slotSize<Node>()>();
+	if(nodes.count >= CACHED_NODES){
+		memoryDelete(MEMORY_THREAD_NODES, node, slotSize<Node>());
+		return;
+	}
+	memoryBudgetCredit(slotSize<Node>());
+	*reinterpret_cast<void**>(node) = nodes.freeList;
+	nodes.freeList = node;
+	++nodes.count;
+}
+
+#endif
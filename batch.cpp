@@ -0,0 +1,254 @@
+#include "mapped.h"
+#include "pipeline.h"
+#include "threadpool.h"
+#include <thread>
+#include <memory>
+#include <optional>
+#include <cstring>
+#include <cstdlib>
+
+/* Evaluates any number of records read from a file, or from stdin when no
+ * file (or "-") is given. Like testfile, a record is three lines: an
+ * operand, another operand and an operator (+ - * / % < > == !=), and
+ * blank lines between records are skipped. Reading and parsing, computing
+ * and printing run on three threads, which hand batches of records to each
+ * other, so each record gets one line of output, in input order: the
+ * result, 1 or 0 for a comparison, or "error: ..." if it can't be evaluated.
+ * The records of a batch are independent, so the computing thread deals
+ * them out a few at a time to the ThreadPool of parallel.h (-j threads,
+ * all the cores by default), which also runs the large additions and
+ * products split between threads, and hands the batches on in the order
+ * they came in.
+ * With -m, a record whose evaluation would hold more than that many bytes
+ * at once gets "error: ..." instead of taking all the memory there is (see
+ * MemoryBudget in memory.h).
+ * Build it with 'make batch.out'; BATCH_NUMBER picks the BigInt type, e.g.
+ * -DBATCH_NUMBER='BigInt<int,ThreadList>' for lists whose nodes come out of
+ * per-thread free lists.
+ */
+
+using namespace std;
+
+#ifndef BATCH_NUMBER
+#define BATCH_NUMBER BigInt<int,Vector>
+#endif
+
+typedef BATCH_NUMBER Number;
+
+const size_t BATCH_RECORDS = 256; //records handed from one stage to the next at a time
+const size_t QUEUED_BATCHES = 8; //batches waiting between two stages, or being computed
+const size_t TASK_RECORDS = 16; //records a thread of the pool evaluates at a time
+
+size_t memoryLimit = SIZE_MAX; //bytes the evaluation of one record may hold, see -m
+
+struct Record{
+	Number first;
+	Number second;
+	char op;
+	Number result;
+	int truth; //the result of a comparison, -1 for arithmetic
+	string error; //why the record couldn't be evaluated, empty if it could
+};
+
+struct Batch{
+	Vector<Record> records;
+	size_t size;
+	Batch():records(0),size{0}{}
+	explicit Batch(size_t capacity):records(capacity),size{0}{}
+};
+
+//the lines of a file straight out of its mapped pages, or of stdin through a string
+class LineSource{
+  public:
+	explicit LineSource(const char *path);
+	bool is_open() const noexcept;
+	bool getLine(const char *&line, size_t &length);
+
+  private:
+	MappedFile file;
+	bool standardInput;
+	string buffer;
+};
+
+LineSource::LineSource(const char *path):standardInput{path == nullptr || strcmp(path, "-") == 0}{
+	if(!standardInput)
+		file.open(path);
+}
+
+bool LineSource::is_open() const noexcept{
+	return standardInput || file.is_open();
+}
+
+//the line stays valid until the next call
+bool LineSource::getLine(const char *&line, size_t &length){
+	if(!standardInput)
+		return file.getLine(line, length);
+	if(!getline(cin, buffer))
+		return false;
+	line = buffer.data();
+	length = buffer.size();
+	return true;
+}
+
+//the next line with something other than whitespace on it
+bool nextFilledLine(LineSource &input, const char *&line, size_t &length){
+	while(input.getLine(line, length)){
+		for(size_t i = 0; i < length; i++){
+			if(!isspace(static_cast<unsigned char>(line[i])))
+				return true;
+		}
+	}
+	return false;
+}
+
+//the operator on a line, without the whitespace around it: '=' stands for ==, '!' for !=
+char parseOperator(const char *line, size_t length){
+	const char *end = line + length;
+	while(line != end && isspace(static_cast<unsigned char>(*line)))
+		++line;
+	while(end != line && isspace(static_cast<unsigned char>(*(end - 1))))
+		--end;
+	string token(line, end);
+	for(const char *known: {"+", "-", "*", "/", "%", "<", ">", "==", "!="}){
+		if(token == known)
+			return token[0];
+	}
+	throw invalid_argument("unknown operator '" + token + "'");
+}
+
+//fills 'record' from the next three filled lines, returns false if the input ends before it
+bool readRecord(LineSource &input, Record &record){
+	const char *line;
+	size_t length;
+	record.error.clear();
+	for(int part = 0; part < 3; part++){
+		if(!nextFilledLine(input, line, length)){
+			if(part == 0)
+				return false;
+			record.error = "the input ended in the middle of a record";
+			return true;
+		}
+		if(!record.error.empty()) //the rest of a broken record is skipped
+			continue;
+		try{
+			if(part < 2)
+				(part == 0? record.first: record.second).parse(line, length);
+			else
+				record.op = parseOperator(line, length);
+		}catch(exception &e){
+			record.error = e.what();
+		}
+	}
+	return true;
+}
+
+void evaluate(Record &record){
+	if(!record.error.empty())
+		return;
+	record.truth = -1;
+	try{
+		optional<MemoryBudget> budget; //without -m, allocations skip the budget's atomic counter
+		if(memoryLimit != SIZE_MAX)
+			budget.emplace(memoryLimit);
+		switch(record.op){
+			case '+': record.result = record.first + record.second; break;
+			case '-': record.result = record.first - record.second; break;
+			case '*': record.result = record.first * record.second; break;
+			case '/': record.result = record.first / record.second; break;
+			case '%': record.result = record.first % record.second; break;
+			case '<': record.truth = (record.first < record.second); break;
+			case '>': record.truth = (record.first > record.second); break;
+			case '=': record.truth = (record.first == record.second); break;
+			case '!': record.truth = (record.first != record.second); break;
+			default: record.error = string("unknown operator '") + record.op + "'";
+		}
+	}catch(exception &e){
+		record.error = e.what();
+	}
+}
+
+void print(ostream &out, const Record &record){
+	if(!record.error.empty())
+		out << "error: " << record.error << '\n';
+	else if(record.truth >= 0)
+		out << record.truth << '\n';
+	else
+		out << record.result << '\n';
+}
+
+//a batch whose records the pool is evaluating
+struct Computing{
+	Batch batch;
+	unique_ptr<TaskGroup> group;
+};
+
+//usage: batch.out [-j threads] [-m bytes] [file]
+int main(int argc, char *argv[]){
+	ios::sync_with_stdio(false);
+	cin.tie(nullptr); //reading stdin would flush cout from the reading thread
+	size_t threads = thread::hardware_concurrency();
+	int arg = 1;
+	while(arg + 1 < argc && (strcmp(argv[arg], "-j") == 0 || strcmp(argv[arg], "-m") == 0)){
+		if(argv[arg][1] == 'j')
+			threads = strtoul(argv[arg + 1], nullptr, 10);
+		else
+			memoryLimit = strtoull(argv[arg + 1], nullptr, 10);
+		arg += 2;
+	}
+	const char *path = (arg < argc? argv[arg]: nullptr);
+	LineSource input(path);
+	if(!input.is_open()){
+		cerr << "Could not open " << path << endl;
+		exit(EXIT_FAILURE);
+	}
+	BlockingQueue<Batch> parsed(QUEUED_BATCHES), computed(QUEUED_BATCHES);
+	parallelThresholds().threads = threads; //before the pool is made
+	ThreadPool &pool = parallelPool(); //the one the kernels of parallel.h split large operands on, so -j bounds them too
+
+	thread reader([&]{
+		bool more = true;
+		while(more){
+			Batch batch(BATCH_RECORDS);
+			while(batch.size < BATCH_RECORDS && (more = readRecord(input, batch.records[batch.size])))
+				++batch.size;
+			if(batch.size > 0)
+				parsed.push(std::move(batch));
+		}
+		parsed.close();
+	});
+	thread computer([&]{
+		deque<Computing> window; //oldest batch first
+		Batch batch;
+		bool more = true;
+		while(more || !window.empty()){
+			if(more && window.size() < QUEUED_BATCHES && (more = parsed.pop(batch))){
+				Record *records = batch.records.begin(); //stays put when the batch is moved
+				window.push_back({std::move(batch), unique_ptr<TaskGroup>(new TaskGroup)});
+				for(size_t from = 0; from < window.back().batch.size; from += TASK_RECORDS){
+					size_t to = min(from + TASK_RECORDS, window.back().batch.size);
+					pool.submit(*window.back().group, [records, from, to]{
+						for(size_t i = from; i < to; i++)
+							evaluate(records[i]);
+					});
+				}
+				continue;
+			}
+			if(window.empty()) //the input ended with no batch in flight, e.g. it was empty
+				continue;
+			pool.wait(*window.front().group);
+			computed.push(std::move(window.front().batch));
+			window.pop_front();
+		}
+		computed.close();
+	});
+
+	Batch batch; //this thread prints
+	while(computed.pop(batch)){
+		for(size_t i = 0; i < batch.size; i++)
+			print(cout, batch.records[i]);
+	}
+	reader.join();
+	computer.join();
+	cout.flush();
+	return 0;
+}
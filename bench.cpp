@@ -0,0 +1,228 @@
+#include "bigint.h"
+#include <chrono>
+#include <random>
+#include <cstdio>
+#include <cstring>
+#include <cstdlib>
+#include <sstream>
+
+/* Times the basic operations of every BigInt instantiation on random
+ * operands of 10 to 10^8 digits: addition, subtraction, comparison (< and ==
+ * of two equal values, which look at every limb), parsing and printing.
+ * Each benchmark repeats its operation, doubling the repetitions, until one
+ * round takes at least --time seconds, and reports the time per call of
+ * that round. Node based containers stop at 10^7 digits, where three
+ * operands of char limbs already take about a gigabyte, and so do binary
+ * limbs, which take about a minute to print at that size.
+ *
+ * Build and run it with 'make bench', which also writes the results to
+ * bench.json. The file has one line per benchmark, always in the same
+ * order, so the files of two releases can be diffed; --baseline prints how
+ * each benchmark compares with an earlier file.
+ *
+ *   --json FILE        writes the results as JSON to FILE ('-' for stdout)
+ *   --baseline FILE    adds the ratio to the time in an earlier JSON file
+ *   --time SECONDS     time of a round (0.05 by default)
+ *   --max-digits N     largest operand size (10^8 by default)
+ *   --filter TEXT      only runs the benchmarks whose name contains TEXT
+ */
+
+using namespace std;
+
+//largest operands of list based containers, and of binary limbs (see radix.h)
+const size_t LIMITED_MAX_DIGITS = 10000000;
+const char *const OPS[] = {"add", "sub", "less", "equal", "parse", "print"};
+
+struct Options{
+	const char *json;
+	const char *baseline;
+	double seconds;
+	size_t maxDigits;
+	const char *filter;
+};
+
+struct Result{
+	string name; //op/type/digits
+	const char *op;
+	const char *type;
+	size_t digits;
+	size_t iterations;
+	double nanoseconds; //per call
+};
+
+Options options = {nullptr, nullptr, 0.05, 100000000, ""};
+Vector<Result> results(0);
+Vector<pair<string, double>> baseline(0); //name and time per call of each earlier benchmark
+volatile size_t sink; //comparison results go here, so they aren't optimized away
+FILE *report = stdout; //the table, stderr when the JSON goes to stdout
+
+//a 'digits' long decimal number, without leading 0's
+string randomDigits(size_t digits, mt19937 &gen){
+	uniform_int_distribution<int> digit(0, 9);
+	string text(digits, '0');
+	text[0] = char(CHAR_OFFSET + 1 + digit(gen) % 9);
+	for(size_t i = 1; i < digits; i++)
+		text[i] = char(CHAR_OFFSET + digit(gen));
+	return text;
+}
+
+//the time per call 'name' had in the baseline, 0 if it isn't there
+double baselineTime(const string &name){
+	for(size_t i = 0; i < baseline.size(); i++){
+		if(baseline[i].first == name)
+			return baseline[i].second;
+	}
+	return 0;
+}
+
+//reads back the benchmarks of a file written by writeJson, one per line
+void readBaseline(const char *path){
+	ifstream in(path);
+	if(!in.is_open()){
+		fprintf(stderr, "Could not open %s\n", path);
+		exit(EXIT_FAILURE);
+	}
+	const string NAME = "\"name\": \"", TIME = "\"ns_per_op\": ";
+	string line;
+	while(getline(in, line)){
+		size_t name = line.find(NAME), time = line.find(TIME);
+		if(name == string::npos || time == string::npos)
+			continue;
+		name += NAME.size();
+		baseline.push_back({line.substr(name, line.find('"', name) - name), atof(line.c_str() + time + TIME.size())});
+	}
+}
+
+string benchName(const char *op, const char *type, size_t digits){
+	return string(op) + "/" + type + "/" + to_string(digits);
+}
+
+//runs 'call' in rounds of twice as many calls as the last, until a round takes options.seconds
+template <typename F>
+void timeOp(const char *op, const char *type, size_t digits, F call){
+	string name = benchName(op, type, digits);
+	if(name.find(options.filter) == string::npos)
+		return;
+	size_t reps = 1;
+	double elapsed;
+	while(true){
+		auto start = chrono::steady_clock::now();
+		for(size_t i = 0; i < reps; i++)
+			call();
+		elapsed = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+		if(elapsed >= options.seconds)
+			break;
+		reps *= 2;
+	}
+	Result result = {name, op, type, digits, reps, elapsed * 1e9 / reps};
+	fprintf(report, "%-26s %10zu  %-6s %16.1f ns", type, digits, op, result.nanoseconds);
+	double before = baselineTime(name);
+	if(before > 0)
+		fprintf(report, "  x%.2f", result.nanoseconds / before);
+	fprintf(report, "\n");
+	fflush(report);
+	results.push_back(result);
+}
+
+template <typename T, template <typename> typename C>
+void benchType(const char *type, size_t digits){
+	if((!is_same<typename C<T>::Iterator, T*>::value || LimbTraits<T>::BINARY) && digits > LIMITED_MAX_DIGITS)
+		return;
+	bool any = false; //the operands aren't made when the filter leaves out all the benchmarks
+	for(const char *op: OPS)
+		any = (any || benchName(op, type, digits).find(options.filter) != string::npos);
+	if(!any)
+		return;
+	mt19937 gen(digits);
+	string first = randomDigits(digits, gen), second = randomDigits(digits - digits / 10, gen);
+	BigInt<T,C> a, b, result;
+	a.parse(first.data(), first.size());
+	b.parse(second.data(), second.size());
+	BigInt<T,C> copy(a);
+	ostringstream out;
+	timeOp("add", type, digits, [&]{ result = a + b; });
+	timeOp("sub", type, digits, [&]{ result = a - b; });
+	timeOp("less", type, digits, [&]{ sink = sink + (a < copy); });
+	timeOp("equal", type, digits, [&]{ sink = sink + (a == copy); });
+	timeOp("parse", type, digits, [&]{ result.parse(first.data(), first.size()); });
+	timeOp("print", type, digits, [&]{
+		out.str(string());
+		out << a;
+	});
+}
+
+//one benchmark per line, in the order they ran
+void writeJson(FILE *out){
+	fprintf(out, "{\n");
+	fprintf(out, "  \"context\": {\"compiler\": \"%s\", \"threads\": %zu, \"seconds_per_round\": %g},\n",
+			__VERSION__, parallelThreads(), options.seconds);
+	fprintf(out, "  \"benchmarks\": [\n");
+	for(size_t i = 0; i < results.size(); i++){
+		const Result &result = results[i];
+		fprintf(out, "    {\"name\": \"%s\", \"op\": \"%s\", \"type\": \"%s\", \"digits\": %zu, "
+					 "\"iterations\": %zu, \"ns_per_op\": %.1f}%s\n",
+				result.name.c_str(), result.op, result.type, result.digits,
+				result.iterations, result.nanoseconds, (i + 1 < results.size()? ",": ""));
+	}
+	fprintf(out, "  ]\n}\n");
+}
+
+//usage: bench.out [--json file] [--baseline file] [--time seconds] [--max-digits n] [--filter text]
+int main(int argc, char *argv[]){
+	for(int arg = 1; arg < argc; arg++){
+		const char *option = argv[arg], *value = (arg + 1 < argc? argv[arg + 1]: nullptr);
+		if(value == nullptr){
+			fprintf(stderr, "%s needs a value\n", option);
+			exit(EXIT_FAILURE);
+		}
+		if(strcmp(option, "--json") == 0)
+			options.json = value;
+		else if(strcmp(option, "--baseline") == 0)
+			options.baseline = value;
+		else if(strcmp(option, "--time") == 0)
+			options.seconds = atof(value);
+		else if(strcmp(option, "--max-digits") == 0)
+			options.maxDigits = strtoull(value, nullptr, 10);
+		else if(strcmp(option, "--filter") == 0)
+			options.filter = value;
+		else{
+			fprintf(stderr, "Unknown option %s\n", option);
+			exit(EXIT_FAILURE);
+		}
+		++arg;
+	}
+	if(options.json != nullptr && strcmp(options.json, "-") == 0)
+		report = stderr;
+	if(options.baseline != nullptr)
+		readBaseline(options.baseline);
+
+	for(size_t digits = 10; digits <= options.maxDigits && digits <= 100000000; digits *= 10){
+		benchType<int,List>("int,List", digits);
+		benchType<char,List>("char,List", digits);
+		benchType<int,ArenaList>("int,ArenaList", digits);
+		benchType<char,ArenaList>("char,ArenaList", digits);
+		benchType<int,ThreadList>("int,ThreadList", digits);
+		benchType<char,ThreadList>("char,ThreadList", digits);
+		benchType<int,ChunkedList>("int,ChunkedList", digits);
+		benchType<char,ChunkedList>("char,ChunkedList", digits);
+		benchType<int,Vector>("int,Vector", digits);
+		benchType<char,Vector>("char,Vector", digits);
+		benchType<int,SmallVector>("int,SmallVector", digits);
+		benchType<char,SmallVector>("char,SmallVector", digits);
+		benchType<long long,Vector>("long long,Vector", digits);
+		benchType<unsigned,Vector>("unsigned,Vector", digits);
+		benchType<unsigned long long,Vector>("unsigned long long,Vector", digits);
+	}
+
+	if(options.json != nullptr){
+		FILE *out = (strcmp(options.json, "-") == 0? stdout: fopen(options.json, "w"));
+		if(out == nullptr){
+			fprintf(stderr, "Could not open %s\n", options.json);
+			exit(EXIT_FAILURE);
+		}
+		writeJson(out);
+		if(out != stdout)
+			fclose(out);
+	}
+	return 0;
+}
@@ -1,13 +1,44 @@
+#ifndef BIGINT_H
+#define BIGINT_H
+
 #include "list.h"
 #include "vector.h"
+#include "chunkedlist.h"
+#include "smallvector.h"
+#include "limb.h"
+#include "multiply.h"
+#include "divide.h"
+#include "radix.h"
+#include "simd.h"
+#include "parallel.h"
+#include "serialize.h"
+#include "hash.h"
+#include "stats.h"
 #include <iostream>
 #include <fstream>
-#include <typeinfo>
+#include <string>
+#include <utility>
+#include <atomic>
+#include <functional>
+#include <type_traits>
+#if __cplusplus >= 202002L
+#include <compare>
+#endif
 
 using namespace std;
 
 const char CHAR_OFFSET = '0';
 
+//the built-in integers (bool aside) a BigInt is made from and mixed with directly;
+//__int128 is named on its own, since it is only integral in the GNU dialects
+template <typename I>
+struct IsNativeInteger:integral_constant<bool, (is_integral<I>::value && !is_same<I,bool>::value)
+											   || is_same<I,__int128>::value
+											   || is_same<I,unsigned __int128>::value>{};
+
+template <typename I>
+using EnableIfNative = typename enable_if<IsNativeInteger<I>::value, int>::type;
+
 template <typename T, template <typename> typename C>
 class BigInt;
 
@@ -17,245 +48,871 @@ ostream& operator<<(ostream& , const BigInt<T,C> &);
 template <typename T, template <typename> typename C>
 ifstream& operator>>(ifstream& , BigInt<T,C> &);
 
+template <typename I, typename T, template <typename> typename C, EnableIfNative<I> = 0>
+BigInt<T,C> operator/(I, const BigInt<T,C> &);
+
+template <typename I, typename T, template <typename> typename C, EnableIfNative<I> = 0>
+BigInt<T,C> operator%(I, const BigInt<T,C> &);
+
 template <typename T, template <typename> typename C>
 class BigInt{
   friend ostream &operator<< <>(ostream& , const BigInt<T,C> &);
   friend ifstream &operator>> <>(ifstream& , BigInt<T,C> &);
+  template <typename I, typename U, template <typename> typename D, EnableIfNative<I>>
+  friend BigInt<U,D> operator/(I, const BigInt<U,D> &);
+  template <typename I, typename U, template <typename> typename D, EnableIfNative<I>>
+  friend BigInt<U,D> operator%(I, const BigInt<U,D> &);
   private:
-	C<T> container;
-  	size_t count;
+	typedef LimbTraits<T> Traits;
+	typedef typename Traits::Wide Wide;
+	//the limbs are one array (Vector, SmallVector), so the kernels of limb.h and simd.h work on them in place
+	static constexpr bool CONTIGUOUS = is_same<typename C<T>::Iterator, T*>::value;
+	C<T> container; //one limb per element, see limb.h
+  	size_t count; //number of limbs
   	bool sign; //stores whether the number is positive or negative
-	bool direction; //how the container is stored (forward or backwards)
+	mutable atomic<size_t> hashCache{0}; //hash() of the value, 0 until it is worked out
+	void changed() noexcept;
+	void setSign(bool) noexcept;
 	void insert(const T&);
-	void addHelper(typename C<T>::Iterator, typename C<T>::Iterator, typename C<T>::Iterator,
-				   size_t, bool, bool, BigInt<T,C>&, int);
+	void copyLimbs(Vector<T>&, bool) const;
+	void assignLimbs(const T*, size_t);
+	const T* contiguousLimbs(Vector<T>&) const;
+	void takeLimbs(Vector<T>&);
+	static void checkSerialHeader(const SerialHeader&);
+	static void checkSerialLimbs(const T*, size_t);
+	typedef unsigned __int128 Native;
+	static constexpr size_t NATIVE_LIMBS = limbNativeLimbs<T>();
+	bool toNative(Native&) const noexcept;
+	bool toNative(const BigInt<T,C>&, Native&, Native&) const noexcept;
+	void assignNative(Native, bool);
+	template <typename I>
+	static Native nativeMagnitude(I) noexcept;
+	static size_t splitNative(Native, T*) noexcept;
+	void accumulateNative(Native, bool);
+	void multiplyNative(Native, bool);
+	void divideNative(Native, bool);
+	Native remainderNative(Native) const;
+	int compareNative(Native, bool) const noexcept;
+	void accumulate(const BigInt<T,C>&, bool);
+	BigInt<T,C> addSigned(const BigInt<T,C>&, bool) const;
+	template <typename Iterator>
+	static void addHelper(Iterator, Iterator, Iterator, size_t, BigInt<T,C>&, int);
+	static void addHelper(T*, T*, T*, size_t, BigInt<T,C>&, int);
+	static void reserveLimbs(C<T>&, size_t);
+	static bool equalLimbs(const C<T>&, const C<T>&, size_t) noexcept;
+	static int compareLimbs(const C<T>&, const C<T>&, size_t) noexcept;
+	int absCompare(const BigInt<T,C>&) const noexcept;
 
   public:
 	BigInt();
 	BigInt(const BigInt<T,C>&);
+	BigInt(BigInt<T,C>&&) noexcept;
+	template <typename I, EnableIfNative<I> = 0>
+	BigInt(I);
 	void negate();
-	void reverse();
 	size_t getCount() const noexcept;
-	const BigInt<T,C> operator+(const BigInt<T,C>&);
-	const BigInt<T,C> operator-(const BigInt<T,C>&);
-	const BigInt<T,C> operator+=(const BigInt<T,C>&);
-	const BigInt<T,C> operator-=(const BigInt<T,C>&);
+	size_t hash() const noexcept;
+	void parse(const char*, size_t);
+	size_t serializedSize() const noexcept;
+	void serialize(char*) const;
+	size_t deserialize(const char*, size_t);
+	void writeBinary(ostream&) const;
+	void readBinary(istream&);
+	BigInt<T,C> operator+(const BigInt<T,C>&) const;
+	BigInt<T,C> operator-(const BigInt<T,C>&) const;
+	BigInt<T,C> operator*(const BigInt<T,C>&) const;
+	BigInt<T,C> operator/(const BigInt<T,C>&) const;
+	BigInt<T,C> operator%(const BigInt<T,C>&) const;
+	void divmod(const BigInt<T,C>&, BigInt<T,C>&, BigInt<T,C>&) const;
+	BigInt<T,C>& operator+=(const BigInt<T,C>&);
+	BigInt<T,C>& operator-=(const BigInt<T,C>&);
+	BigInt<T,C>& operator*=(const BigInt<T,C>&);
+	BigInt<T,C>& operator/=(const BigInt<T,C>&);
+	BigInt<T,C>& operator%=(const BigInt<T,C>&);
 	const BigInt<T,C>& operator=(const BigInt<T,C>&);
+	const BigInt<T,C>& operator=(BigInt<T,C>&&) noexcept;
 	bool absEquals(const BigInt<T,C>&) const noexcept;
 	bool operator==(const BigInt<T,C>&) const noexcept;
 	bool operator!=(const BigInt<T,C>&) const noexcept;
 	bool absGreaterThan(const BigInt<T,C> &other) const noexcept;
+	int compare(const BigInt<T,C>&) const noexcept;
 	bool operator>(const BigInt<T,C> &) const noexcept;
 	bool operator<(const BigInt<T,C> &) const noexcept;
+	bool operator>=(const BigInt<T,C> &) const noexcept;
+	bool operator<=(const BigInt<T,C> &) const noexcept;
+#if __cplusplus >= 202002L
+	strong_ordering operator<=>(const BigInt<T,C> &) const noexcept;
+#endif
+	template <typename I, EnableIfNative<I> = 0>
+	const BigInt<T,C>& operator=(I);
+	template <typename I, EnableIfNative<I> = 0>
+	BigInt<T,C> operator+(I) const;
+	template <typename I, EnableIfNative<I> = 0>
+	BigInt<T,C> operator-(I) const;
+	template <typename I, EnableIfNative<I> = 0>
+	BigInt<T,C> operator*(I) const;
+	template <typename I, EnableIfNative<I> = 0>
+	BigInt<T,C> operator/(I) const;
+	template <typename I, EnableIfNative<I> = 0>
+	BigInt<T,C> operator%(I) const;
+	template <typename I, EnableIfNative<I> = 0>
+	BigInt<T,C>& operator+=(I);
+	template <typename I, EnableIfNative<I> = 0>
+	BigInt<T,C>& operator-=(I);
+	template <typename I, EnableIfNative<I> = 0>
+	BigInt<T,C>& operator*=(I);
+	template <typename I, EnableIfNative<I> = 0>
+	BigInt<T,C>& operator/=(I);
+	template <typename I, EnableIfNative<I> = 0>
+	BigInt<T,C>& operator%=(I);
+	BigInt<T,C>& operator++();
+	BigInt<T,C> operator++(int);
+	BigInt<T,C>& operator--();
+	BigInt<T,C> operator--(int);
+	template <typename I, EnableIfNative<I> = 0>
+	int compare(I) const noexcept;
+	template <typename I, EnableIfNative<I> = 0>
+	bool operator==(I) const noexcept;
+	template <typename I, EnableIfNative<I> = 0>
+	bool operator!=(I) const noexcept;
+	template <typename I, EnableIfNative<I> = 0>
+	bool operator>(I) const noexcept;
+	template <typename I, EnableIfNative<I> = 0>
+	bool operator<(I) const noexcept;
+	template <typename I, EnableIfNative<I> = 0>
+	bool operator>=(I) const noexcept;
+	template <typename I, EnableIfNative<I> = 0>
+	bool operator<=(I) const noexcept;
+#if __cplusplus >= 202002L
+	template <typename I, EnableIfNative<I> = 0>
+	strong_ordering operator<=>(I) const noexcept;
+#endif
 };//BigInt class
 
 /////////////////////////// FRIEND FUNCTIONS //////////////////////////////////
 
+//the digits are put together in one buffer, and written to 'out' at once
 template <typename T, template <typename> typename C>
 ostream& operator<<(ostream &out, const BigInt<T,C> &bigint){
+	typedef LimbTraits<T> Traits;
+	BIGINT_STAT_SCOPE(STAT_WRITE, bigint.count);
 	if(bigint.count == 0) //for an empty BigInt, print out '0'
-		out << "0";
-	else{
-		(bigint.sign == 0? out << "-" : out << " ");
-		if(bigint.direction){ //case where BigInt is stored in forward order
-			typename C<T>::Iterator last = bigint.container.end();
-			typename C<T>::Iterator first = bigint.container.begin();
-			if(typeid(T) == typeid(char)){
-				while(first != last){
-					char intRepresentation = *first + CHAR_OFFSET;
-					out << intRepresentation;
-					++first;
-				}
-			}
-			else{
-				while(first != last){
-					out << *first;
-					++first;
-				}
-			}
-		}
-		else{ //case where BigInt is stored in reverse order
-			typename C<T>::Iterator last = bigint.container.prev(bigint.container.begin());
-			typename C<T>::Iterator first = bigint.container.prev(bigint.container.end());
-			if(typeid(T) == typeid(char)){
-				while(first != last){
-					char intRepresentation = *first + CHAR_OFFSET;
-					out << intRepresentation;
-					--first;
-				}
-			}
-			else{
-				while(first != last){
-					out << *first;
-					--first;
-				}
-			}
-		}
+		return out << "0";
+	string text; //the sign in front of the digits, possibly after some leading 0's
+	if constexpr(!Traits::BINARY){ //decimal limbs are groups of DIGITS digits
+		text.resize(1 + bigint.count * Traits::DIGITS);
+		char *digits = &text[1];
+		typename C<T>::Iterator limb = bigint.container.end();
+		for(size_t i = 0; i < bigint.count; i++, digits += Traits::DIGITS)
+			radixPutDigits(digits, Traits::DIGITS, static_cast<unsigned long long>(*(--limb)));
+	}
+	else{ //binary limbs need a radix conversion, see radix.h
+		Vector<T> limbs;
+		bigint.copyLimbs(limbs, false);
+		text.resize(1 + radixDigits<T>(limbs.size()));
+		radixToDecimal(limbs.begin(), limbs.size(), &text[1], text.size() - 1);
 	}
-	return out;	
+	size_t start = text.find_first_not_of('0', 1); //the top limb isn't 0, so there is such a digit
+	text[start - 1] = (bigint.sign == 0? '-': ' ');
+	return out.write(text.data() + start - 1, text.size() - start + 1);
 }
 
-//BigInts are created in order from greatest-value to smallest-value digit
+//a BigInt is read from one line, see BigInt::parse
 template <typename T, template <typename> typename C>
 ifstream& operator>>(ifstream &in, BigInt<T,C> &bigint){ 
+	BIGINT_STAT_SCOPE(STAT_READ, 0);
 	string reader;
-	char traverse;
-    traverse = in.peek();
-    if(traverse == '+' || traverse == '-'){
-    	in >> traverse;
-		if(traverse == '-')
-			bigint.sign = 0;
-	}
-	while(in.get(traverse) && traverse != '\n'){
-		if(traverse == '0'){
-			if(bigint.count > 0)
-				bigint.insert(traverse - CHAR_OFFSET);
-		}
-		else
-			bigint.insert(traverse - CHAR_OFFSET);
-	}
+	getline(in, reader); //the whole line in one go, rather than a character at a time
+	bigint.parse(reader.data(), reader.size());
+	BIGINT_STAT_LIMBS(bigint.count);
 	return in;
 }
 
 /////////////////////////// PRIVATE METHODS ///////////////////////////////////
 
+//forgets the cached hash, called by everything that changes the value
+template <typename T, template <typename> typename C>
+void BigInt<T,C>::changed() noexcept{
+	hashCache.store(0, memory_order_relaxed);
+}
+
+//every sign written into a copy or a result goes through here, so it can't keep a hash worked out for the old sign
+template <typename T, template <typename> typename C>
+void BigInt<T,C>::setSign(bool positive) noexcept{
+	sign = positive;
+	changed();
+}
+
 template <typename T, template <typename> typename C>
 void BigInt<T,C>::insert(const T& value){
 	container.push_back(value);
 	++count;
 }
 
-//'G' relates to object with greater count, 'S' relates to object with smaller count
+//appends every limb to 'limbs', most significant first if 'bigEndian' is set
 template <typename T, template <typename> typename C>
-void BigInt<T,C>::addHelper(typename C<T>::Iterator beginG, 
-							typename C<T>::Iterator endG,
-							typename C<T>::Iterator beginS,
-							size_t countS,
-							bool dirG, bool dirS, BigInt<T,C> &object, int code){
-	auto addDigits = [](T& temporary, T& carriedVal, BigInt<T,C> &obj) { //lambda expression for adding
-		temporary += carriedVal;
-		if (temporary >= 10){
-			temporary -= 10;
-			carriedVal = 1;
+void BigInt<T,C>::copyLimbs(Vector<T> &limbs, bool bigEndian) const{
+	limbs.reserve(limbs.size() + count);
+	if(bigEndian){
+		typename C<T>::Iterator limb = container.end();
+		for(size_t i = 0; i < count; i++)
+			limbs.push_back(*(--limb));
+	}
+	else{
+		for(typename C<T>::Iterator limb = container.begin(); limb != container.end(); ++limb)
+			limbs.push_back(*limb);
+	}
+}
+
+//replaces the value with the little-endian limbs (leading 0's are dropped), keeping the sign
+template <typename T, template <typename> typename C>
+void BigInt<T,C>::assignLimbs(const T *limbs, size_t length){
+	changed();
+	container.clear();
+	count = 0;
+	length = limbNormalize(limbs, length);
+	reserveLimbs(container, length);
+	for(size_t i = 0; i < length; i++)
+		insert(limbs[i]);
+	if(count == 0)
+		sign = 1;
+}
+
+//the limbs least significant first in one array: the container itself if it is contiguous,
+//otherwise 'scratch' once they are copied there
+template <typename T, template <typename> typename C>
+const T* BigInt<T,C>::contiguousLimbs(Vector<T> &scratch) const{
+	if constexpr(CONTIGUOUS)
+		return container.begin();
+	else{
+		copyLimbs(scratch, false);
+		return scratch.begin();
+	}
+}
+
+//replaces the value with the little-endian 'limbs' (leading 0's are dropped), keeping the sign;
+//a Vector container takes the array over instead of copying it
+template <typename T, template <typename> typename C>
+void BigInt<T,C>::takeLimbs(Vector<T> &limbs){
+	if constexpr(is_same<C<T>, Vector<T>>::value){
+		changed();
+		while(!limbs.empty() && limbs.back() == 0)
+			limbs.pop_back();
+		container = std::move(limbs);
+		count = container.size();
+		if(count == 0)
+			sign = 1;
+	}
+	else
+		assignLimbs(limbs.begin(), limbs.size());
+}
+
+//throws unless the serialized limbs are of the same kind as T
+template <typename T, template <typename> typename C>
+void BigInt<T,C>::checkSerialHeader(const SerialHeader &header){
+	if(header.limbSize != sizeof(T) || header.binary != Traits::BINARY)
+		throw invalid_argument("BigInt::checkSerialHeader: error! tried reading limbs of another type");
+}
+
+//throws unless every limb is in [0, BASE) and the top one isn't 0, like the limbs of any BigInt
+template <typename T, template <typename> typename C>
+void BigInt<T,C>::checkSerialLimbs(const T *limbs, size_t n){
+	if constexpr(!Traits::BINARY){ //any bit pattern is a valid binary limb
+		for(size_t i = 0; i < n; i++){
+			if(limbs[i] < T(0) || typename Traits::Wide(limbs[i]) >= Traits::BASE)
+				throw invalid_argument("BigInt::checkSerialLimbs: error! tried reading a limb outside of the base");
 		}
-		else
-		carriedVal = 0;
-		obj.container.push_back(temporary);
-		obj.count++;
-	};
-	T carry = 0;
-	if(code == 1){
-		if(dirG == dirS){ // if both BigInts are stored in the same direction
-			if(dirG){ // if both are stored in forwards order
-				for(size_t total = 0; beginG != endG; total++){
-					T temp = *beginG + (total < countS? *beginS: 0);
-					addDigits(temp, carry, object);
-					--beginG;
-					--beginS;
-				}
-			}	
-			else{ //if both are stored in reverse order
-				for(size_t total = 0; beginG != endG; total++){
-					T temp = *beginG + (total < countS? *beginS: 0);
-					addDigits(temp, carry, object);
-					++beginG;
-					++beginS;
-				}
-			}
+	}
+	if(n > 0 && limbs[n-1] == 0)
+		throw invalid_argument("BigInt::checkSerialLimbs: error! tried reading a BigInt with leading 0 limbs");
+}
+
+//the magnitude as one 128 bit value, if it fits in one
+template <typename T, template <typename> typename C>
+bool BigInt<T,C>::toNative(Native &magnitude) const noexcept{
+	if(count > NATIVE_LIMBS + 1)
+		return false;
+	magnitude = 0;
+	typename C<T>::Iterator limb = container.end();
+	for(size_t i = 0; i < count; i++){
+		--limb;
+		if(i < NATIVE_LIMBS) //NATIVE_LIMBS limbs always fit, one more only for some values
+			magnitude = magnitude * Native(Traits::BASE) + Native(*limb);
+		else if(__builtin_mul_overflow(magnitude, Native(Traits::BASE), &magnitude)
+				|| __builtin_add_overflow(magnitude, Native(*limb), &magnitude))
+			return false;
+	}
+	return true;
+}
+
+//both magnitudes as 128 bit values, if both fit, for the fast paths of the operators
+template <typename T, template <typename> typename C>
+bool BigInt<T,C>::toNative(const BigInt<T,C> &other, Native &left, Native &right) const noexcept{
+	return this->toNative(left) && other.toNative(right);
+}
+
+//replaces the value with 'magnitude', made negative unless 'positive' is set (or it is 0);
+//a SmallVector container holds any such value without allocating
+template <typename T, template <typename> typename C>
+void BigInt<T,C>::assignNative(Native magnitude, bool positive){
+	T limbs[NATIVE_LIMBS + 1];
+	size_t length = splitNative(magnitude, limbs);
+	changed();
+	container.clear();
+	count = 0;
+	for(size_t i = 0; i < length; i++)
+		insert(limbs[i]);
+	sign = (positive || count == 0);
+}
+
+//the magnitude of a built-in integer, the most negative value of a signed type included
+template <typename T, template <typename> typename C>
+template <typename I>
+typename BigInt<T,C>::Native BigInt<T,C>::nativeMagnitude(I value) noexcept{
+	return (value < I(0)? Native(0) - Native(value): Native(value));
+}
+
+//writes the limbs of 'magnitude' to 'limbs' (room for NATIVE_LIMBS + 1), least significant first,
+//and returns how many there are
+template <typename T, template <typename> typename C>
+size_t BigInt<T,C>::splitNative(Native magnitude, T *limbs) noexcept{
+	size_t length = 0;
+	if constexpr(!Traits::BINARY){ //decimal limbs are divided out 64 bits at a time once the rest fits
+		while(magnitude >> 64 != 0){
+			limbs[length++] = static_cast<T>(magnitude % Native(Traits::BASE));
+			magnitude /= Native(Traits::BASE);
 		}
-		else if(dirG){ //if the bigger obj is forwards, and smaller is reverse order
-			for(size_t total = 0; beginG != endG; total++){
-				T temp = *beginG + (total < countS? *beginS: 0);
-				addDigits(temp, carry, object);
-				--beginG;
-				++beginS;
-			}
+		for(unsigned long long rest = static_cast<unsigned long long>(magnitude); rest != 0; rest /= Traits::BASE)
+			limbs[length++] = static_cast<T>(rest % Traits::BASE);
+	}
+	else{
+		while(magnitude != 0){
+			limbs[length++] = static_cast<T>(magnitude % Native(Traits::BASE));
+			magnitude /= Native(Traits::BASE);
 		}
-		else{ //if the bigger object is reverse order, and smaller is forwards
-			for(size_t total = 0; beginG != endG; total++){
-				T temp = *beginG + (total < countS? *beginS: 0);
-				addDigits(temp, carry, object);
-				++beginG;
-				--beginS;
-			}
+	}
+	return length;
+}
+
+//adds 'magnitude', made negative unless 'positive' is set, in place like accumulate: the carry
+//or borrow only goes as far as it has to, and limbs are only appended when the sum grows
+template <typename T, template <typename> typename C>
+void BigInt<T,C>::accumulateNative(Native magnitude, bool positive){
+	BIGINT_STAT_SCOPE(STAT_ACCUMULATE, count);
+	changed();
+	Native mine;
+	if(count > 0 && sign != positive && toNative(mine) && mine < magnitude){ //the sign flips, the rest fits in 128 bits
+		assignNative(magnitude - mine, positive);
+		return;
+	}
+	T limbs[NATIVE_LIMBS + 1];
+	size_t length = splitNative(magnitude, limbs);
+	if(length == 0)
+		return;
+	typename C<T>::Iterator limb = container.begin();
+	size_t i = 0;
+	if(count == 0 || sign == positive){
+		sign = positive;
+		T carry = 0;
+		for(; i < count && (i < length || carry); i++, ++limb){
+			Wide sum = Wide(*limb) + Wide(carry) + (i < length? Wide(limbs[i]): Wide(0));
+			carry = (sum >= Traits::BASE);
+			*limb = static_cast<T>(carry? sum - Traits::BASE: sum);
 		}
+		for(; i < length || carry; i++){ //past the top limb of 'this'
+			Wide sum = Wide(carry) + (i < length? Wide(limbs[i]): Wide(0));
+			carry = (sum >= Traits::BASE);
+			insert(static_cast<T>(carry? sum - Traits::BASE: sum));
+		}
+		return;
+	}
+	T borrow = 0; //|this| >= magnitude, so the borrow stops below the top limb
+	for(; i < count && (i < length || borrow); i++, ++limb){
+		Wide subtrahend = Wide(borrow) + (i < length? Wide(limbs[i]): Wide(0));
+		borrow = (Wide(*limb) < subtrahend);
+		*limb = static_cast<T>((borrow? Wide(*limb) + Traits::BASE: Wide(*limb)) - subtrahend);
 	}
-	else if(code == 2){
-		if(dirG == dirS){ // if both BigInts are stored in the same direction
-			if(dirG){ // if both are stored in forwards order
-				for(size_t total = 0; beginG != endG; total++){
-					T temp = *beginG + (total < countS? (9 - *beginS): 9);
-					addDigits(temp, carry, object);
-						--beginG;
-					--beginS;
-				}
-			}	
-			else{ //if both are stored in reverse order
-				for(size_t total = 0; beginG != endG; total++){
-					T temp = *beginG + (total < countS? (9 - *beginS): 9);
-					addDigits(temp, carry, object);
-						++beginG;
-					++beginS;
-				}
+	while(count > 0 && container.back() == 0){ //drop the leading 0's
+		container.pop_back();
+		--count;
+	}
+	sign = (sign || count == 0);
+}
+
+//multiplies the magnitude by 'factor' in place, a single pass over the limbs when it is one limb,
+//and gives the product the sign 'positive'
+template <typename T, template <typename> typename C>
+void BigInt<T,C>::multiplyNative(Native factor, bool positive){
+	changed();
+	Native mine, product;
+	if(count == 0 || factor == 0){
+		container.clear();
+		count = 0;
+		sign = 1;
+		return;
+	}
+	if(factor < Native(Traits::BASE)){
+		Wide carry = 0;
+		if constexpr(CONTIGUOUS)
+			carry = limbMulSmall(container.begin(), container.begin(), count, static_cast<T>(factor));
+		else{
+			typename C<T>::Iterator limb = container.begin();
+			for(size_t i = 0; i < count; i++, ++limb){
+				Wide current = Wide(*limb) * Wide(factor) + carry;
+				*limb = static_cast<T>(current % Traits::BASE);
+				carry = current / Traits::BASE;
 			}
 		}
-		else if(dirG){ //if the bigger obj is forwards, and smaller is reverse order
-			for(size_t total = 0; beginG != endG; total++){
-				T temp = *beginG + (total < countS? (9 - *beginS): 9);
-				addDigits(temp, carry, object);
-				--beginG;
-				++beginS;
+		if(carry != 0)
+			insert(static_cast<T>(carry));
+		sign = positive;
+	}
+	else if(toNative(mine) && !__builtin_mul_overflow(mine, factor, &product))
+		assignNative(product, positive);
+	else{
+		T limbs[NATIVE_LIMBS + 1];
+		size_t length = splitNative(factor, limbs);
+		Vector<T> left;
+		copyLimbs(left, false);
+		Vector<T> product(left.size() + length);
+		limbMul(product.begin(), left.begin(), left.size(), limbs, length);
+		sign = positive;
+		assignLimbs(product.begin(), product.size());
+	}
+}
+
+//divides the magnitude by the nonzero 'divisor' in place, rounding towards 0, a single pass
+//over the limbs when it is one limb, and gives the quotient the sign 'positive'
+template <typename T, template <typename> typename C>
+void BigInt<T,C>::divideNative(Native divisor, bool positive){
+	changed();
+	Native mine;
+	if(divisor < Native(Traits::BASE)){
+		if constexpr(CONTIGUOUS)
+			limbDivSmall(container.begin(), container.begin(), count, static_cast<T>(divisor));
+		else{
+			Wide remainder = 0;
+			typename C<T>::Iterator limb = container.end();
+			for(size_t i = 0; i < count; i++){
+				--limb;
+				Wide current = remainder * Traits::BASE + Wide(*limb);
+				*limb = static_cast<T>(current / Wide(divisor));
+				remainder = current % Wide(divisor);
 			}
 		}
-		else{ //if the bigger object is reverse order, and smaller is forwards
-			for(size_t total = 0; beginG != endG; total++){
-				T temp = *beginG + (total < countS? (9 - *beginS): 9);
-				addDigits(temp, carry, object);
-				++beginG;
-				--beginS;
+		while(count > 0 && container.back() == 0){ //drop the leading 0's
+			container.pop_back();
+			--count;
+		}
+		sign = (positive || count == 0);
+	}
+	else if(toNative(mine))
+		assignNative(mine / divisor, positive);
+	else{ //|this| doesn't fit in 128 bits, so it has more limbs than 'divisor'
+		T limbs[NATIVE_LIMBS + 1];
+		size_t length = splitNative(divisor, limbs);
+		Vector<T> left;
+		copyLimbs(left, false);
+		Vector<T> qLimbs(left.size() - length + 1), rLimbs(length);
+		limbDivmod(qLimbs.begin(), rLimbs.begin(), left.begin(), left.size(), limbs, length);
+		sign = positive;
+		assignLimbs(qLimbs.begin(), qLimbs.size());
+	}
+}
+
+//the magnitude modulo the nonzero 'divisor', read off the limbs without changing them
+template <typename T, template <typename> typename C>
+typename BigInt<T,C>::Native BigInt<T,C>::remainderNative(Native divisor) const{
+	Native mine;
+	if(toNative(mine))
+		return mine % divisor;
+	if(divisor < Native(Traits::BASE)){
+		Wide remainder = 0;
+		typename C<T>::Iterator limb = container.end();
+		for(size_t i = 0; i < count; i++){
+			--limb;
+			remainder = (remainder * Traits::BASE + Wide(*limb)) % Wide(divisor);
+		}
+		return Native(remainder);
+	}
+	T limbs[NATIVE_LIMBS + 1];
+	size_t length = splitNative(divisor, limbs);
+	Vector<T> left;
+	copyLimbs(left, false);
+	Vector<T> qLimbs(left.size() - length + 1), rLimbs(length);
+	limbDivmod(qLimbs.begin(), rLimbs.begin(), left.begin(), left.size(), limbs, length);
+	Native remainder = 0;
+	for(size_t i = length; i-- > 0;)
+		remainder = remainder * Native(Traits::BASE) + Native(rLimbs[i]);
+	return remainder;
+}
+
+//-1, 0 or 1 as the value is below, equal to or above 'magnitude' made negative unless 'positive' is set
+template <typename T, template <typename> typename C>
+int BigInt<T,C>::compareNative(Native magnitude, bool positive) const noexcept{
+	BIGINT_STAT_SCOPE(STAT_COMPARE, count);
+	positive = (positive || magnitude == 0);
+	if(sign != positive) //'0' is positive, so the signs alone decide
+		return (sign? 1: -1);
+	Native mine;
+	int order = (!toNative(mine) || mine > magnitude? 1: (mine < magnitude? -1: 0));
+	return (sign? order: -order);
+}
+
+//adds 'other' (subtracts it if 'subtract' is set) into the existing limbs, appending only
+//the limbs the result grows by; 'this' has to be nonzero
+template <typename T, template <typename> typename C>
+void BigInt<T,C>::accumulate(const BigInt<T,C> &other, bool subtract){
+	if(other.count == 0)
+		return;
+	changed();
+	bool otherSign = (subtract? !other.sign: other.sign);
+	if(other.count > this->count) //the result has at most one limb more than 'other'
+		reserveLimbs(this->container, other.count + 1);
+	typename C<T>::Iterator travThis = this->container.begin();
+	typename C<T>::Iterator travOther = other.container.begin();
+
+	if(this->sign == otherSign){
+		T carry = 0;
+		for(size_t i = 0; i < other.count || carry; i++){
+			if(i >= other.count && i < this->count && *travThis != Traits::BASE - 1){ //the carry stops here
+				++(*travThis);
+				break;
+			}
+			Wide sum = Wide(carry);
+			if(i < other.count){
+				sum += Wide(*(travOther++));
 			}
+			if(i < this->count)
+				sum += Wide(*travThis);
+			carry = (sum >= Traits::BASE);
+			T limb = static_cast<T>(carry? sum - Traits::BASE: sum);
+			if(i < this->count)
+				*(travThis++) = limb;
+			else
+				insert(limb);
 		}
+		return;
 	}
-	if(carry){
-		if(code == 1){
+
+	if(this->absEquals(other)){
+		this->container.clear();
+		this->count = 0;
+		this->sign = 1;
+		return;
+	}
+	bool flip = other.absGreaterThan(*this); //the result is other - this, with the sign of 'other'
+	size_t length = (flip? other.count: this->count);
+	T borrow = 0;
+	for(size_t i = 0; i < length; i++){
+		if(!flip && i >= other.count && !borrow) //nothing left to subtract
+			break;
+		Wide mine = (i < this->count? Wide(*travThis): 0), theirs = 0;
+		if(i < other.count){
+			theirs = Wide(*(travOther++));
+		}
+		Wide minuend = (flip? theirs: mine), subtrahend = (flip? mine: theirs) + Wide(borrow);
+		borrow = (minuend < subtrahend);
+		T limb = static_cast<T>((borrow? minuend + Traits::BASE: minuend) - subtrahend);
+		if(i < this->count)
+			*(travThis++) = limb;
+		else
+			insert(limb);
+	}
+	while(this->container.back() == 0){ //drop the leading 0's
+		this->container.pop_back();
+		--this->count;
+	}
+	if(flip)
+		this->sign = otherSign;
+}
+
+//'G' relates to the object with the greater magnitude, 'S' to the smaller one;
+//code 1 appends G + S to 'object', code 2 appends G - S
+template <typename T, template <typename> typename C>
+template <typename Iterator>
+void BigInt<T,C>::addHelper(Iterator beginG, 
+							Iterator endG,
+							Iterator beginS,
+							size_t countS,
+							BigInt<T,C> &object, int code){
+	BIGINT_STAT_SCOPE(code == 1? STAT_ADD_HELPER_SUM: STAT_ADD_HELPER_DIFFERENCE, countS);
+	object.changed();
+	auto addDigits = [](Wide temporary, T& carriedVal, BigInt<T,C> &obj) { //lambda expression for adding
+		temporary += carriedVal;
+		if (temporary >= Traits::BASE){
+			temporary -= Traits::BASE;
+			carriedVal = 1;
+		}
+		else
+		carriedVal = 0;
+		obj.container.push_back(static_cast<T>(temporary));
+		obj.count++;
+	};
+	auto subDigits = [](Wide minuend, Wide subtrahend, T& borrowedVal, BigInt<T,C> &obj) { //lambda expression for subtracting
+		subtrahend += borrowedVal;
+		if (minuend < subtrahend){
+			minuend += Traits::BASE;
+			borrowedVal = 1;
+		}
+		else
+		borrowedVal = 0;
+		obj.container.push_back(static_cast<T>(minuend - subtrahend));
+		obj.count++;
+	};
+	T carry = 0; //carry for code 1, borrow for code 2
+	if(code == 1){
+		for(size_t total = 0; total < countS; total++)
+			addDigits(Wide(*(beginG++)) + Wide(*(beginS++)), carry, object);
+		while(beginG != endG) //only the carry is left to add
+			addDigits(Wide(*(beginG++)), carry, object);
+		BIGINT_STAT_LIMBS(object.count);
+		if(carry){
 			object.container.push_back(carry);
 			object.count++;
 		}
-		else if(code == 2){
-			BigInt<T,C> carryAdder;
-			carryAdder.insert(carry);
-			object += carryAdder;  //in 9's comp you have to add the carry
-		}
+	}
+	else if(code == 2){ //'G' is at least as large as 'S', so the borrow never goes past the top
+		for(size_t total = 0; total < countS; total++)
+			subDigits(Wide(*(beginG++)), Wide(*(beginS++)), carry, object);
+		while(beginG != endG) //only the borrow is left to subtract
+			subDigits(Wide(*(beginG++)), 0, carry, object);
+		BIGINT_STAT_LIMBS(object.count);
 	}
 	
 	//removes any 0's at the beginning of the number
-	while(*object.container.prev(object.container.end()) == 0){
+	while(object.count > 0 && object.container.back() == 0){
 		object.container.pop_back();
 		--object.count;
 	}
 }
 
+//contiguous storage (BigInt<T,Vector>, BigInt<T,SmallVector>): 'object' is empty, and is filled by the SIMD kernels of simd.h,
+//split between threads for very long operands (see parallel.h)
+template <typename T, template <typename> typename C>
+void BigInt<T,C>::addHelper(T *beginG, T *endG, T *beginS, size_t countS, BigInt<T,C> &object, int code){
+	size_t countG = endG - beginG;
+	BIGINT_STAT_SCOPE(code == 1? STAT_ADD_HELPER_SUM: STAT_ADD_HELPER_DIFFERENCE, countG + countS);
+	object.changed();
+	object.container = C<T>(countG + 1);
+	T *result = object.container.begin();
+	if(code == 1){
+		T carry = parallelAddN(result, beginG, beginS, countS);
+		result[countG] = limbAddCarry(result + countS, beginG + countS, countG - countS, carry);
+	}
+	else{ //'G' is at least as large as 'S', so the borrow never goes past the top
+		T borrow = parallelSubN(result, beginG, beginS, countS);
+		limbSubBorrow(result + countS, beginG + countS, countG - countS, borrow);
+		result[countG] = 0;
+	}
+	object.count = limbNormalize(result, countG + 1);
+	while(object.container.size() > object.count) //removes any 0's at the beginning of the number
+		object.container.pop_back();
+}
+
+//makes room for 'n' limbs in contiguous containers, so that appending them doesn't reallocate;
+//node based containers allocate per element anyway
+template <typename T, template <typename> typename C>
+void BigInt<T,C>::reserveLimbs(C<T> &limbs, size_t n){
+	if constexpr(CONTIGUOUS)
+		limbs.reserve(n);
+}
+
+//whether the n limbs 'a' and 'b' hold are equal
+template <typename T, template <typename> typename C>
+bool BigInt<T,C>::equalLimbs(const C<T> &a, const C<T> &b, size_t n) noexcept{
+	if constexpr(CONTIGUOUS)
+		return simdEqual(a.begin(), b.begin(), n);
+	else{
+		typename C<T>::Iterator travA = a.begin();
+		typename C<T>::Iterator travB = b.begin();
+		for(size_t i = 0; i < n; i++){
+			if(*(travA++) != *(travB++))
+				return false;
+		}
+		return true;
+	}
+}
+
+//compares the n limbs 'a' and 'b' hold from the most significant one down, returning -1, 0 or 1
+template <typename T, template <typename> typename C>
+int BigInt<T,C>::compareLimbs(const C<T> &a, const C<T> &b, size_t n) noexcept{
+	if constexpr(CONTIGUOUS)
+		return simdCompare(a.begin(), b.begin(), n);
+	else{
+		typename C<T>::Iterator travA = a.end();
+		typename C<T>::Iterator travB = b.end();
+		for(size_t i = 0; i < n; i++){
+			--travA;
+			--travB;
+			if(*travA != *travB)
+				return (*travA > *travB? 1: -1);
+		}
+		return 0;
+	}
+}
+
+//-1, 0 or 1 as |this| is below, equal to or above |other|; the limbs are only walked when the lengths match
+template <typename T, template <typename> typename C>
+int BigInt<T,C>::absCompare(const BigInt<T,C> &other) const noexcept{
+	if(this->count != other.count)
+		return (this->count > other.count? 1: -1);
+	return compareLimbs(this->container, other.container, this->count);
+}
+
 /////////////////////////// PUBLIC METHODS ////////////////////////////////////
 
 //default constructor
 template <typename T, template <typename> typename C>
-BigInt<T,C>::BigInt():count{0},sign{1},direction{1}{}
+BigInt<T,C>::BigInt():count{0},sign{1}{}
 
-//negates a BigInt
+//negates a BigInt; '0' stays positive
 template <typename T, template <typename> typename C>
 void BigInt<T,C>::negate(){
-	sign = (!sign);
+	changed();
+	sign = (!sign || count == 0);
 }
 
-//reverse a BigInt (switch the order of digits)
 template <typename T, template <typename> typename C>
-void BigInt<T,C>::reverse(){
-	direction = (!direction);	
+size_t BigInt<T,C>::getCount() const noexcept{
+	return count;	
 }
 
+//a hash of the value, worked out on the first call and kept until the value changes
 template <typename T, template <typename> typename C>
-size_t BigInt<T,C>::getCount() const noexcept{
-	return count;	
+size_t BigInt<T,C>::hash() const noexcept{
+	size_t cached = hashCache.load(memory_order_relaxed);
+	if(cached != 0)
+		return cached;
+	uint64_t hashed = hashLimbs<T>(container.begin(), count, sign? HASH_P1: HASH_P2);
+	cached = (static_cast<size_t>(hashed) != 0? static_cast<size_t>(hashed): 1); //0 stands for no hash yet
+	hashCache.store(cached, memory_order_relaxed);
+	return cached;
+}
+
+//replaces the value with the one written in text[0, length): an optional sign, then decimal digits
+//from greatest-value to smallest-value (a trailing '\r' is ignored); the digits are read where they are
+template <typename T, template <typename> typename C>
+void BigInt<T,C>::parse(const char *text, size_t length){
+	BIGINT_STAT_SCOPE(STAT_PARSE, 0);
+	const char *end = text + length;
+	bool positive = true;
+	if(text != end && (*text == '+' || *text == '-'))
+		positive = (*(text++) == '+');
+	while(end != text && *(end - 1) == '\r')
+		--end;
+	for(const char *digit = text; digit != end; ++digit){ //the value is left as it was if the text is turned down
+		if(*digit < '0' || *digit > '9')
+			throw invalid_argument("BigInt::parse: error! tried reading a non-digit character");
+	}
+	while(text != end && *text == '0') //skips leading 0's
+		++text;
+	length = end - text;
+	changed();
+	container.clear();
+	count = 0;
+	if constexpr(!Traits::BINARY){ //each limb is a group of DIGITS characters, read from the back
+		reserveLimbs(container, (length + Traits::DIGITS - 1) / Traits::DIGITS);
+		size_t last = length;
+		while(last > 0){
+			size_t first = (last > Traits::DIGITS? last - Traits::DIGITS: 0);
+			Wide limb = 0;
+			for(size_t i = first; i < last; i++)
+				limb = limb * 10 + (text[i] - CHAR_OFFSET);
+			insert(static_cast<T>(limb));
+			last = first;
+		}
+	}
+	else{ //binary limbs need a radix conversion, see radix.h
+		Vector<T> limbs = radixFromDecimal<T>(text, length);
+		assignLimbs(limbs.begin(), limbs.size());
+	}
+	sign = (positive || count == 0);
+	BIGINT_STAT_LIMBS(count);
+}
+
+//bytes serialize() writes, see serialize.h
+template <typename T, template <typename> typename C>
+size_t BigInt<T,C>::serializedSize() const noexcept{
+	return SERIAL_HEADER + count * sizeof(T);
+}
+
+//writes the header and the limbs to buffer[0, serializedSize())
+template <typename T, template <typename> typename C>
+void BigInt<T,C>::serialize(char *buffer) const{
+	Vector<T> scratch(0);
+	char *limbBytes = buffer + SERIAL_HEADER;
+	serialStoreLimbs(limbBytes, contiguousLimbs(scratch), count);
+	SerialHeader header = {sign, sizeof(T), Traits::BINARY, count, serialChecksum(limbBytes, count * sizeof(T))};
+	serialStoreHeader(buffer, header);
+}
+
+//reads a BigInt serialize() wrote at the front of buffer[0, size) (such as a mapped file),
+//returns the bytes it took up, so that the next one can be read after it
+template <typename T, template <typename> typename C>
+size_t BigInt<T,C>::deserialize(const char *buffer, size_t size){
+	if(size < SERIAL_HEADER)
+		throw invalid_argument("BigInt::deserialize: error! tried reading a truncated BigInt");
+	SerialHeader header = serialLoadHeader(buffer);
+	checkSerialHeader(header);
+	if(header.count > (size - SERIAL_HEADER) / sizeof(T))
+		throw invalid_argument("BigInt::deserialize: error! tried reading a truncated BigInt");
+	const char *limbBytes = buffer + SERIAL_HEADER;
+	size_t length = header.count * sizeof(T);
+	if(serialChecksum(limbBytes, length) != header.checksum)
+		throw invalid_argument("BigInt::deserialize: error! the checksum doesn't match the limbs");
+	Vector<T> limbs(header.count);
+	serialLoadLimbs(limbs.begin(), limbBytes, header.count);
+	checkSerialLimbs(limbs.begin(), header.count);
+	setSign(header.sign);
+	takeLimbs(limbs);
+	return SERIAL_HEADER + length;
+}
+
+//writes the same bytes as serialize(), straight from the limbs when they are contiguous
+template <typename T, template <typename> typename C>
+void BigInt<T,C>::writeBinary(ostream &out) const{
+	if(!SERIAL_NATIVE){
+		Vector<char> buffer(serializedSize());
+		serialize(buffer.begin());
+		out.write(buffer.begin(), buffer.size());
+		return;
+	}
+	Vector<T> scratch(0);
+	const char *limbBytes = reinterpret_cast<const char*>(contiguousLimbs(scratch));
+	size_t length = count * sizeof(T);
+	char header[SERIAL_HEADER];
+	serialStoreHeader(header, {sign, sizeof(T), Traits::BINARY, count, serialChecksum(limbBytes, length)});
+	out.write(header, SERIAL_HEADER);
+	if(length > 0)
+		out.write(limbBytes, length);
+}
+
+//reads what writeBinary() wrote, the limbs in pieces of SERIAL_PIECE bytes
+template <typename T, template <typename> typename C>
+void BigInt<T,C>::readBinary(istream &in){
+	char bytes[SERIAL_HEADER];
+	if(!in.read(bytes, SERIAL_HEADER))
+		throw invalid_argument("BigInt::readBinary: error! tried reading a truncated BigInt");
+	SerialHeader header = serialLoadHeader(bytes);
+	checkSerialHeader(header);
+	if(header.count > SIZE_MAX / sizeof(T))
+		throw invalid_argument("BigInt::readBinary: error! tried reading more limbs than fit in memory");
+	size_t length = header.count * sizeof(T);
+	string limbBytes; //grows a piece at a time, as the limbs actually arrive
+	while(limbBytes.size() < length){
+		size_t read = limbBytes.size(), piece = min(length - read, SERIAL_PIECE);
+		limbBytes.resize(read + piece);
+		if(!in.read(&limbBytes[read], piece))
+			throw invalid_argument("BigInt::readBinary: error! tried reading a truncated BigInt");
+	}
+	if(serialChecksum(limbBytes.data(), length) != header.checksum)
+		throw invalid_argument("BigInt::readBinary: error! the checksum doesn't match the limbs");
+	Vector<T> limbs(header.count);
+	serialLoadLimbs(limbs.begin(), limbBytes.data(), header.count);
+	checkSerialLimbs(limbs.begin(), header.count);
+	setSign(header.sign);
+	takeLimbs(limbs);
 }
 
 //copy constructor
@@ -264,521 +921,183 @@ BigInt<T,C>::BigInt(const BigInt<T,C> &other){
 	*this = other;
 }
 
+//move constructor, 'other' is left with value '0'
 template <typename T, template <typename> typename C>
-const BigInt<T,C> BigInt<T,C>::operator+(const BigInt<T,C> &other){
-	if(this->count == 0) //case when "this" is a BigInt with value '0'
-		return other;
-	if(other.count == 0) //case when "other" is a BigInt with value '0'
-		return *this;
+BigInt<T,C>::BigInt(BigInt<T,C> &&other) noexcept
+	:container{std::move(other.container)},count{other.count},sign{other.sign},
+	 hashCache{other.hashCache.load(memory_order_relaxed)}{
+	other.count = 0;
+	other.setSign(1);
+}
+
+//from a built-in integer, int64_t, uint64_t and __int128 included
+template <typename T, template <typename> typename C>
+template <typename I, EnableIfNative<I>>
+BigInt<T,C>::BigInt(I value):count{0},sign{1}{
+	assignNative(nativeMagnitude(value), !(value < I(0)));
+}
+
+//this + other, with 'otherSign' in place of the sign of 'other'
+template <typename T, template <typename> typename C>
+BigInt<T,C> BigInt<T,C>::addSigned(const BigInt<T,C> &other, bool otherSign) const{
 	BigInt<T,C> returner;
-	returner.direction = 0; //after addition, all BigInts are stored in reverse
-	if(this->sign == other.sign){
-		bool bigger = (this->count >= other.count? 1: 0); //find the larger BigInt
-		if(this->direction == other.direction){
-			if(this->direction){ //both BigInts are stored in forwards order
-				if(bigger){ //if 'this' BigInt has a greater/equal count
-					addHelper(this->container.prev(this->container.end()),
-						 	  this->container.prev(this->container.begin()),
-						  	  other.container.prev(other.container.end()),
-						 	  other.count,
-							  this->direction, other.direction, returner, 1);
-				}else //executes when 'other' has a greater count
-					addHelper(other.container.prev(other.container.end()),
-							  other.container.prev(other.container.begin()),
-							  this->container.prev(this->container.end()),
-							  this->count,
-							  other.direction, this->direction, returner, 1);
-			}	
-			else{ //case when both BigInts are stored in reverse order
-				if(bigger)
-					addHelper(this->container.begin(),
-							  this->container.end(),
-							  other.container.begin(),
-							  other.count,
-							  this->direction, other.direction, returner, 1);
-				else
-					addHelper(other.container.begin(),
-							  other.container.end(),
-							  this->container.begin(),
-							  this->count,
-							  other.direction, this->direction, returner, 1);
-			}
-		}
-		else{ //when the BigInts are stored in opposite directions
-			if(this->direction){ //'this' is stored forwards, other is backwards
-				if(bigger) //if 'this' BigInt has a greater/equal count
-					addHelper(this->container.prev(this->container.end()),
-							  this->container.prev(this->container.begin()),
-							  other.container.begin(),
-							  other.count,
-							  this->direction, other.direction, returner, 1);
-				else //executes when 'other' has a greater count
-					addHelper(other.container.begin(),
-							  other.container.end(),
-							  this->container.prev(this->container.end()),
-							  this->count,
-							  other.direction, this->direction, returner, 1);
-			}
-			else{ // 'this' is stored backwards, and other is stored forwards
-				if(bigger) //if 'this' BigInt has a greater/equal count
-					addHelper(this->container.begin(),
-							  this->container.end(),
-							  other.container.prev(other.container.end()),
-							  other.count,
-							  this->direction, other.direction, returner, 1);
-				else //execures when 'other' has a greater count
-					addHelper(other.container.prev(other.container.end()),
-							  other.container.prev(other.container.begin()),
-							  this->container.begin(),
-							  this->count,
-							  other.direction, this->direction, returner, 1);
-			}
-		}
-		returner.sign = this->sign;
-		return returner;
-	}//if nothing returned, do subtraction-like operations using 9's complement
-	else{
-		if(this->absEquals(other))
-			return BigInt();
-		if(this->sign && !other.sign){
-			if(this->absGreaterThan(other)){
-				if(this->direction == other.direction){
-					if(this->direction){
-						addHelper(this->container.prev(this->container.end()),
-								  this->container.prev(this->container.begin()),
-								  other.container.prev(other.container.end()),
-								  other.count,
-								  this->direction, other.direction, returner, 2);
-					}
-					else{
-						addHelper(this->container.begin(),
-								  this->container.end(),
-								  other.container.begin(),
-								  other.count,
-								  this->direction, other.direction, returner, 2);
-					}
-				}
-				else{
-					if(this->direction){
-						addHelper(this->container.prev(this->container.end()),
-								  this->container.prev(this->container.begin()),
-								  other.container.begin(),
-								  other.count,
-								  this->direction, other.direction, returner, 2);
-					}
-					else{
-						addHelper(this->container.begin(),
-								  this->container.end(),
-								  other.container.prev(other.container.end()),
-								  other.count,
-								  this->direction, other.direction, returner, 2);
-					}
-				}
-				returner.sign = 1;
-			}
-			else{
-				if(this->direction == other.direction){
-					if(this->direction){
-						addHelper(other.container.prev(other.container.end()),
-								  other.container.prev(other.container.begin()),
-								  this->container.prev(this->container.end()),
-								  this->count,
-								  other.direction, this->direction, returner, 2);
-					}
-					else{
-						addHelper(other.container.begin(),
-								  other.container.end(),
-								  this->container.begin(),
-								  this->count,
-								  other.direction, this->direction, returner, 2);
-					}
-				}
-				else{
-					if(this->direction){
-						addHelper(other.container.prev(other.container.end()),
-								  other.container.prev(other.container.begin()),
-								  this->container.begin(),
-								  this->count,
-								  other.direction, this->direction, returner, 2);
-					}
-					else{
-						addHelper(other.container.begin(),
-								  other.container.end(),
-								  this->container.prev(this->container.end()),
-								  this->count,
-								  other.direction, this->direction, returner, 2);
-					}
-				}
-				returner.sign = 0;
-			}
+	Native left, right, sum;
+	if(toNative(other, left, right)){ //small values are added as they are
+		if(this->sign != otherSign){
+			returner.assignNative(left >= right? left - right: right - left, (left >= right? this->sign: otherSign));
+			return returner;
 		}
-		else{ //when this is negative and other is positive
-			if(this->absGreaterThan(other)){
-				if(this->direction == other.direction){
-					if(this->direction){
-						addHelper(this->container.prev(this->container.end()),
-								  this->container.prev(this->container.begin()),
-								  other.container.prev(other.container.end()),
-								  other.count,
-								  this->direction, other.direction, returner, 2);
-					}
-					else{
-						addHelper(this->container.begin(),
-								  this->container.end(),
-								  other.container.begin(),
-								  other.count,
-								  this->direction, other.direction, returner, 2);
-					}
-				}
-				else{
-					if(this->direction){
-						addHelper(this->container.prev(this->container.end()),
-								  this->container.prev(this->container.begin()),
-								  other.container.begin(),
-								  other.count,
-								  this->direction, other.direction, returner, 2);
-					}
-					else{
-						addHelper(this->container.begin(),
-								  this->container.end(),
-								  other.container.prev(other.container.end()),
-								  other.count,
-								  this->direction, other.direction, returner, 2);
-					}
-				}
-				returner.sign = 0;
-			}
-			else{
-				if(this->direction == other.direction){
-					if(this->direction){
-						addHelper(other.container.prev(other.container.end()),
-								  other.container.prev(other.container.begin()),
-								  this->container.prev(this->container.end()),
-								  this->count,
-								  other.direction, this->direction, returner, 2);
-					}
-					else{
-						addHelper(other.container.begin(),
-								  other.container.end(),
-								  this->container.begin(),
-								  this->count,
-								  other.direction, this->direction, returner, 2);
-					}
-				}
-				else{
-					if(this->direction){
-						addHelper(other.container.prev(other.container.end()),
-								  other.container.prev(other.container.begin()),
-								  this->container.begin(),
-								  this->count,
-								  other.direction, this->direction, returner, 2);
-					}
-					else{
-						addHelper(other.container.begin(),
-								  other.container.end(),
-								  this->container.prev(this->container.end()),
-								  this->count,
-								  other.direction, this->direction, returner, 2);
-					}
-				}
-				returner.sign = 1;
-			}
+		if(!__builtin_add_overflow(left, right, &sum)){
+			returner.assignNative(sum, otherSign);
+			return returner;
 		}
-		return returner;
 	}
+	if(other.count == 0) //case when "other" is a BigInt with value '0'
+		returner = *this;
+	else if(this->count == 0){ //case when "this" is a BigInt with value '0'
+		returner = other;
+		returner.setSign(otherSign);
+	}
+	else if(this->sign == otherSign){ //the magnitudes add up, and keep the common sign
+		const BigInt<T,C> &greater = (this->count >= other.count? *this: other);
+		const BigInt<T,C> &smaller = (this->count >= other.count? other: *this);
+		addHelper(greater.container.begin(), greater.container.end(),
+				  smaller.container.begin(), smaller.count, returner, 1);
+		returner.setSign(otherSign);
+	}
+	else if(!this->absEquals(other)){ //the smaller magnitude is taken from the greater one, equal ones cancel out to '0'
+		bool bigger = this->absGreaterThan(other);
+		const BigInt<T,C> &greater = (bigger? *this: other);
+		const BigInt<T,C> &smaller = (bigger? other: *this);
+		addHelper(greater.container.begin(), greater.container.end(),
+				  smaller.container.begin(), smaller.count, returner, 2);
+		returner.setSign(bigger? this->sign: otherSign);
+	}
+	return returner;
+}
+
+template <typename T, template <typename> typename C>
+BigInt<T,C> BigInt<T,C>::operator+(const BigInt<T,C> &other) const{
+	BIGINT_STAT_SCOPE(STAT_ADD, count + other.count);
+	return addSigned(other, other.sign);
+}
+
+template <typename T, template <typename> typename C>
+BigInt<T,C> BigInt<T,C>::operator-(const BigInt<T,C> &other) const{
+	BIGINT_STAT_SCOPE(STAT_SUB, count + other.count);
+	return addSigned(other, !other.sign);
 }
 
+//the algorithm is picked by operand size, see multiply.h
 template <typename T, template <typename> typename C>
-const BigInt<T,C> BigInt<T,C>::operator-(const BigInt<T,C> &other){
+BigInt<T,C> BigInt<T,C>::operator*(const BigInt<T,C> &other) const{
+	BIGINT_STAT_SCOPE(STAT_MUL, count + other.count);
 	BigInt<T,C> returner;
-	if(*this == other)
+	if(this->count == 0 || other.count == 0) //case when either BigInt has value '0'
 		return returner;
-	bool bigger = (this->count >= other.count? 1: 0); //find the larger BigInt
-	returner.direction = 0; //after subtraction, all BigInts are stored in reverse
-	if(this->sign && other.sign){ // CASE 1 -- SIGNS ARE BOTH POSITIVE
-		if(*this == other) return returner;
-		if(this->direction == other.direction){ // if both are going in the same direction
-			if(this->direction){ //both are stored in forwards order
-				if(*this > other){
-					addHelper(this->container.prev(this->container.end()),
-							  this->container.prev(this->container.begin()),
-							  other.container.prev(other.container.end()),
-							  other.count,
-							  this->direction, other.direction, returner, 2);
-				returner.sign = 1;
-				}
-				else{
-					addHelper(other.container.prev(other.container.end()),
-							  other.container.prev(other.container.begin()),
-							  this->container.prev(this->container.end()),
-							  this->count,
-							  other.direction, this->direction, returner, 2);
-				returner.sign = 0;
-				}
-			}
-			else{
-				if(*this > other){
-					addHelper(this->container.begin(),
-							  this->container.end(),
-							  other.container.begin(),
-							  other.count,
-							  this->direction, other.direction, returner, 2);
-				returner.sign = 1;
-				}
-				else{
-					addHelper(other.container.begin(),
-							  other.container.end(),
-							  this->container.begin(),
-							  this->count,
-							  other.direction, this->direction, returner, 2);
-				returner.sign = 0;
-				}
-			}
-		}
-		else{ //when they are going in opposite directions, but still both positive
-			if(this->direction){ // this is positive direction
-				if(*this > other){
-					addHelper(this->container.prev(this->container.end()),
-							  this->container.prev(this->container.end()),
-							  other.container.begin(),
-							  other.count,
-							  this->direction, other.direction, returner, 2);
-				returner.sign = 1;
-				}
-				else{
-					addHelper(other.container.begin(),
-							  other.container.end(),
-							  this->container.prev(this->container.end()),
-							  this->count,
-							  other.direction, this->direction, returner, 2);
-				returner.sign = 0;
-				}
-			}
-			else{ // this is in negative direction, other is going in the positive direction
-				if(*this > other){
-					addHelper(this->container.begin(),
-							  this->container.end(),
-							  other.container.prev(other.container.end()),
-							  other.count,
-							  this->direction, other.direction, returner, 2);
-					returner.sign = 1;
-				}
-				else{
-					addHelper(other.container.prev(other.container.end()),
-							  other.container.prev(other.container.begin()),
-							  this->container.begin(),
-							  this->count,
-							  other.direction, this->direction, returner, 2);
-					returner.sign = 0;
-				}
-			}
-		}	
-	}
-	else if(this->sign && !other.sign){ //this is positive, the other is negative
-		if(this->direction == other.direction){ //both are stored forwards
-			if(this->direction){
-				if(bigger)
-					addHelper(this->container.prev(this->container.end()),
-							  this->container.prev(this->container.begin()),
-							  other.container.prev(other.container.end()),
-							  other.count,
-							  this->direction, other.direction, returner, 1);
-				else
-					addHelper(other.container.prev(other.container.end()),
-							  other.container.prev(other.container.begin()),
-							  this->container.prev(this->container.end()),
-							  this->count,
-							  other.direction, this->direction, returner, 1);
-			}
-			else{ //both are stored in the backwards direction
-				if(bigger)
-					addHelper(this->container.end(),
-							  this->container.begin(),
-							  other.container.end(),
-							  other.count,
-							  this->direction, other.direction, returner, 1);
-				else
-					addHelper(other.container.end(),
-							  other.container.begin(),
-							  this->container.end(),
-							  this->count,
-							  other.direction, this->direction, returner, 1);
-			}
-		}
-		else{ //if the directions are not equal
-			if(this->direction){ // if this is forwards and the other is backwards
-				if(bigger)
-					addHelper(this->container.prev(this->container.end()),
-							  this->container.prev(this->container.begin()),
-							  other.container.begin(),
-							  other.count,
-							  this->direction, other.direction, returner, 1);
-				else
-					addHelper(other.container.begin(),
-							  other.container.end(),
-							  this->container.prev(this->container.end()),
-							  this->count,
-							  other.direction, this->direction, returner, 1);
-			}
-			else{ //if this is backwards and the other is forwards
-				if(bigger)
-					addHelper(this->container.begin(),
-							  this->container.end(),
-							  other.container.prev(other.container.end()),
-							  other.count,
-							  this->direction, other.direction, returner, 1);
-				else
-					addHelper(other.container.prev(other.container.end()),
-							  other.container.prev(other.container.begin()),
-							  this->container.begin(),
-							  this->count,
-							  other.direction, this->direction, returner, 1);
-			}
-		}
-		// addHelper regular (..., 1) (CASE 2)
-		returner.sign = 1;
-	}
-	else if(!(this->sign) && other.sign){ //if this is negative and the other is positive
-		if(this->direction == other.direction){ //both are going in the same direction
-			if(this->direction){ //if both are going forwards
-				if(bigger)
-					addHelper(this->container.prev(this->container.end()),
-							  this->container.prev(this->container.begin()),
-							  other.container.prev(other.container.end()),
-							  other.count,
-							  this->direction, other.direction, returner, 1);
-				else
-					addHelper(other.container.prev(other.container.end()),
-							  other.container.prev(other.container.begin()),
-							  this->container.prev(this->container.end()),
-							  this->count,
-							  other.direction, this->direction, returner, 1);
-			}
-			else{ //if both are stored backwards
-				if(bigger)
-					addHelper(this->container.begin(),
-							  this->container.end(),
-							  other.container.begin(),
-							  other.count,
-							  this->direction, other.direction, returner, 1);
-				else
-					addHelper(other.container.begin(),
-							  other.container.end(),
-							  this->container.begin(),
-							  this->count,
-							  other.direction, this->direction, returner, 1);
-			}
-		}
-		else if(this->direction){ //this is stored forwards, other is stored backwards
-			if(bigger)
-				addHelper(this->container.prev(this->container.end()),
-						  this->container.prev(this->container.begin()),
-						  other.container.begin(),
-						  other.count,
-						  this->direction, other.direction, returner, 1);
-			else
-				addHelper(other.container.begin(),
-						  other.container.end(),
-						  this->container.prev(this->container.end()),
-						  this->count,
-						  other.direction, this->direction, returner, 1);
+	Native leftNative, rightNative, nativeProduct;
+	//small values whose product fits in 128 bits are multiplied as they are
+	if(toNative(other, leftNative, rightNative) && !__builtin_mul_overflow(leftNative, rightNative, &nativeProduct)){
+		returner.assignNative(nativeProduct, this->sign == other.sign);
+		return returner;
+	}
+	Vector<T> left, right;
+	this->copyLimbs(left, false);
+	other.copyLimbs(right, false);
+	Vector<T> product(left.size() + right.size());
+	limbMul(product.begin(), left.begin(), left.size(), right.begin(), right.size());
+	returner.setSign(this->sign == other.sign);
+	returner.assignLimbs(product.begin(), product.size());
+	return returner;
+}
 
-		}
-		else{ //this is stored backwards, other is stored forwards
-			if(bigger)
-				addHelper(this->container.begin(),
-						  this->container.end(),
-						  other.container.prev(other.container.end()),
-						  other.count,
-						  this->direction, other.direction, returner, 1);
-			else
-				addHelper(other.container.prev(other.container.end()),
-						  other.container.prev(other.container.begin()),
-						  this->container.begin(),
-						  this->count,
-						  other.direction, this->direction, returner, 1);
-		}
-		// addHelper regular (..., 1) (CASE 3)
-		returner.sign = 0;
+//quotient is rounded towards 0, and remainder takes the sign of 'this' (like the built-in types)
+template <typename T, template <typename> typename C>
+void BigInt<T,C>::divmod(const BigInt<T,C> &divisor, BigInt<T,C> &quotient, BigInt<T,C> &remainder) const{
+	BIGINT_STAT_SCOPE(STAT_DIVMOD, count + divisor.count);
+	if(divisor.count == 0)
+		throw domain_error("BigInt::divmod: error! tried dividing by zero");
+	BigInt<T,C> q, r;
+	Native left, right;
+	if(toNative(divisor, left, right)){ //small values are divided as they are
+		q.assignNative(left / right, this->sign == divisor.sign);
+		r.assignNative(left % right, this->sign);
 	}
-	else{ //if both of the numbers are negative
-		if(*this == other)
-			return returner;
-		if(this->absGreaterThan(other)){ //
-			if(this->direction == other.direction){ // if both are going in the same direction
-				if(this->direction) // if both are stored forwards
-					addHelper(this->container.prev(this->container.end()),
-							  this->container.prev(this->container.begin()),
-							  other.container.prev(other.container.end()),
-							  other.count,
-							  this->direction, other.direction, returner, 2);
-				else // if both are stored backwards
-					addHelper(this->container.begin(),
-							  this->container.end(),
-							  other.container.begin(),
-							  other.count,
-							  this->direction, other.direction, returner, 2);
-			}
-			else{ //if both are going in opposing directions
-				if(this->direction) //if this is forwards, other is backwards
-					addHelper(this->container.prev(this->container.end()),
-							  this->container.prev(this->container.begin()),
-							  other.container.begin(),
-							  other.count,
-							  this->direction, other.direction, returner, 2);
-				else //if this is backwards, other is forwards
-					addHelper(this->container.begin(),
-							  this->container.end(),
-							  other.container.prev(other.container.end()),
-							  other.count,
-							  this->direction, other.direction, returner, 2);
-			}
-			returner.sign = 0;
-		}
-		else{ // if other >= this
-			if(this->direction == other.direction){ // if both are going in the same direction
-				if(this->direction) //if both are stored forwards
-					addHelper(other.container.prev(other.container.end()),
-							  other.container.prev(other.container.begin()),
-							  this->container.prev(this->container.end()),
-							  this->count,
-							  other.direction, this->direction, returner, 2);
-				else //if both are stored backwards
-					addHelper(other.container.begin(),
-							  other.container.end(),
-							  this->container.begin(),
-							  this->count,
-							  other.direction, this->direction, returner, 2);
-			}
-			else{ //if both are going in opposing directions
-				if(this->direction) //if this is forwards, other is backwards
-					addHelper(other.container.begin(),
-							  other.container.end(),
-							  this->container.prev(this->container.begin()),
-							  this->count,
-							  other.direction, this->direction, returner, 2);
-				else //if this is backwards, other is forwards
-					addHelper(other.container.prev(other.container.end()),
-							  other.container.prev(other.container.begin()),
-							  this->container.begin(),
-							  this->count,
-							  other.direction, this->direction, returner, 2);
-			}
-			returner.sign = 1;
-		}
+	else if(divisor.absGreaterThan(*this)) //case when |this| < |divisor|, so the quotient is '0'
+		r = *this;
+	else{
+		Vector<T> left, right;
+		this->copyLimbs(left, false);
+		divisor.copyLimbs(right, false);
+		Vector<T> qLimbs(left.size() - right.size() + 1), rLimbs(right.size());
+		limbDivmod(qLimbs.begin(), rLimbs.begin(), left.begin(), left.size(), right.begin(), right.size());
+		q.setSign(this->sign == divisor.sign);
+		q.assignLimbs(qLimbs.begin(), qLimbs.size());
+		r.setSign(this->sign);
+		r.assignLimbs(rLimbs.begin(), rLimbs.size());
 	}
-	return returner;
+	quotient = std::move(q);
+	remainder = std::move(r);
+}
+
+template <typename T, template <typename> typename C>
+BigInt<T,C> BigInt<T,C>::operator/(const BigInt<T,C> &other) const{
+	BigInt<T,C> quotient, remainder;
+	divmod(other, quotient, remainder);
+	return quotient;
+}
+
+template <typename T, template <typename> typename C>
+BigInt<T,C> BigInt<T,C>::operator%(const BigInt<T,C> &other) const{
+	BigInt<T,C> quotient, remainder;
+	divmod(other, quotient, remainder);
+	return remainder;
+}
+
+//adds in place, only allocating for limbs the sum grows by
+template <typename T, template <typename> typename C>
+BigInt<T,C>& BigInt<T,C>::operator+=(const BigInt<T,C> &other){
+	BIGINT_STAT_SCOPE(STAT_ACCUMULATE, count + other.count);
+	if(this == &other) //the limbs of 'other' would change under it
+		*this = *this + other;
+	else if(this->count == 0)
+		*this = other;
+	else
+		accumulate(other, false);
+	return *this;
 }
 
+//subtracts in place, only allocating for limbs the difference grows by
 template <typename T, template <typename> typename C>
-const BigInt<T,C> BigInt<T,C>::operator+=(const BigInt<T,C> &other){
-	*this = *this + other;		
+BigInt<T,C>& BigInt<T,C>::operator-=(const BigInt<T,C> &other){
+	BIGINT_STAT_SCOPE(STAT_ACCUMULATE, count + other.count);
+	if(this == &other) //the limbs of 'other' would change under it
+		*this = *this - other;
+	else if(this->count == 0){
+		*this = other;
+		if(this->count > 0)
+			negate();
+	}
+	else
+		accumulate(other, true);
+	return *this;
+}
+
+template <typename T, template <typename> typename C>
+BigInt<T,C>& BigInt<T,C>::operator*=(const BigInt<T,C> &other){
+	*this = *this * other;
+	return *this;
+}
+
+template <typename T, template <typename> typename C>
+BigInt<T,C>& BigInt<T,C>::operator/=(const BigInt<T,C> &other){
+	*this = *this / other;
 	return *this;
 }
 
 template <typename T, template <typename> typename C>
-const BigInt<T,C> BigInt<T,C>::operator-=(const BigInt<T,C> &other){
-	*this = *this - other;
+BigInt<T,C>& BigInt<T,C>::operator%=(const BigInt<T,C> &other){
+	*this = *this % other;
 	return *this;
 }
 
@@ -787,48 +1106,38 @@ const BigInt<T,C>& BigInt<T,C>::operator=(const BigInt<T,C> &other){
 	this->container = other.container;
 	this->count = other.count;
 	this->sign = other.sign;
-	this->direction = other.direction;
+	this->hashCache.store(other.hashCache.load(memory_order_relaxed), memory_order_relaxed);
 	return *this;
 }
 
+//move assignment, 'other' is left with value '0'
 template <typename T, template <typename> typename C>
-bool BigInt<T,C>::absEquals(const BigInt<T,C> &other) const noexcept{
-	if(this->count == other.count){
-		typename C<T>::Iterator travThis;
-		typename C<T>::Iterator travOther;
-		typename C<T>::Iterator stopHere;
-
-		if(this->direction == other.direction){
-			travThis = this->container.prev(this->container.end());
-			travOther = other.container.prev(other.container.end());
-			stopHere = this->container.prev(this->container.begin());
-			while(travThis != stopHere){
-				if(*travThis != *travOther)
-					return false;
-				--travThis;
-				--travOther;
-			}
-			return true;
-		}
-		else{
-			travThis = this->container.prev(this->container.end());
-			travOther = other.container.begin();
-			stopHere = this->container.prev(this->container.begin());
-			while(travThis != stopHere){
-				if(*travThis != *travOther)
-					return false;
-				--travThis;
-				++travOther;
-			}
-			return true;
-		}
+const BigInt<T,C>& BigInt<T,C>::operator=(BigInt<T,C> &&other) noexcept{
+	if(&other != this){
+		this->container = std::move(other.container);
+		this->count = other.count;
+		this->sign = other.sign;
+		this->hashCache.store(other.hashCache.load(memory_order_relaxed), memory_order_relaxed);
+		other.count = 0;
+		other.setSign(1);
 	}
-	return false;
+	return *this;
+}
+
+template <typename T, template <typename> typename C>
+bool BigInt<T,C>::absEquals(const BigInt<T,C> &other) const noexcept{
+	if(this->count != other.count)
+		return false;
+	return equalLimbs(this->container, other.container, this->count);
 }
 
 template <typename T, template <typename> typename C>
 bool BigInt<T,C>::operator==(const BigInt<T,C> &other) const noexcept{
-	if(this->sign != other.sign)
+	BIGINT_STAT_SCOPE(STAT_COMPARE, count + other.count);
+	if(this->sign != other.sign || this->count != other.count)
+		return false;
+	size_t mine = hashCache.load(memory_order_relaxed), theirs = other.hashCache.load(memory_order_relaxed);
+	if(mine != 0 && theirs != 0 && mine != theirs) //both hashes are known, and differ
 		return false;
 	return absEquals(other);
 }
@@ -840,153 +1149,315 @@ bool BigInt<T,C>::operator!=(const BigInt<T,C> &other) const noexcept{
 
 template <typename T, template <typename> typename C>
 bool BigInt<T,C>::absGreaterThan(const BigInt<T,C> &other) const noexcept{
-	if(this->count > other.count)
-		return true;
-	else if(other.count > this->count)
-		return false;
-	else{
-		typename C<T>::Iterator travThis;
-		typename C<T>::Iterator travOther;
-		typename C<T>::Iterator stopHere;
-		
-		if(this->direction == other.direction){
-			if(this->direction){
-				travThis = this->container.begin();
-				travOther = other.container.begin();
-				stopHere = this->container.end();
-				while(travThis != stopHere){
-					if(*travThis > *travOther)
-						return true;
-					else if(*travOther > *travThis)
-						return false;
-					++travThis;
-					++travOther;
-				}
-			}
-			else{	
-				travThis = this->container.prev(this->container.end());
-				travOther = other.container.prev(other.container.end());
-				stopHere = this->container.prev(this->container.begin());
-				while(travThis != stopHere){
-					if(*travThis > *travOther)
-						return true;
-					else if(*travOther > *travThis)
-						return false;
-					--travThis;
-					--travOther;
-				}
-			}
-		}
-		else{
-			if(this->direction){
-				travThis = this->container.begin();	
-				travOther = other.container.prev(other.container.end());
-				stopHere = this->container.end();
-				while(travThis != stopHere){
-					if(*travThis > *travOther)
-						return true;
-					else if(*travOther > *travThis)
-						return false;
-					++travThis;
-					--travOther;
-				}
-			}
-			else{
-				travThis = this->container.prev(this->container.end());	
-				travOther = other.container.begin();
-				stopHere = this->container.prev(this->container.begin());
-				while(travThis != stopHere){
-					if(*travThis > *travOther)
-						return true;
-					else if(*travOther > *travThis)
-						return false;
-					--travThis;
-					++travOther;
-				}
-			}
-		}
-		return false;
-	}
+	return absCompare(other) > 0;
+}
+
+//-1, 0 or 1 as the value is below, equal to or above 'other': the signs, then the lengths settle
+//most comparisons, and otherwise a single walk from the most significant limb does
+template <typename T, template <typename> typename C>
+int BigInt<T,C>::compare(const BigInt<T,C> &other) const noexcept{
+	BIGINT_STAT_SCOPE(STAT_COMPARE, count + other.count);
+	if(this->sign != other.sign) //'0' is positive, so the signs alone decide
+		return (this->sign? 1: -1);
+	int order = absCompare(other);
+	return (this->sign? order: -order);
 }
 
 template <typename T, template <typename> typename C>
 bool BigInt<T,C>::operator>(const BigInt<T,C> &other) const noexcept{
-	if(*this != other && !(*this < other))
-		return true;
-	return false;
+	return compare(other) > 0;
 }
 
 template <typename T, template <typename> typename C>
 bool BigInt<T,C>::operator<(const BigInt<T,C> &other) const noexcept{
-	if(this->sign && !(other.sign))
-		return false;
-	if(!(this->sign) && other.sign)
-		return true;
-	if(this->count < other.count)
-		return (this->sign? 1: 0);
-	else if(other.count < this->count)
-		return (this->sign? 0: 1);
-	else{
-		typename C<T>::Iterator travThis;
-		typename C<T>::Iterator travOther;
-		typename C<T>::Iterator stopHere;
-		
-		if(this->direction == other.direction){
-			if(this->direction){
-				travThis = this->container.begin();
-				travOther = other.container.begin();
-				stopHere = this->container.end();
-				while(travThis != stopHere){
-					if(*travThis < *travOther)
-						return (this->sign? 1: 0);
-					else if(*travOther < *travThis)
-						return (this->sign? 0: 1);
-					++travThis;
-					++travOther;
-				}
-			}
-			else{	
-				travThis = this->container.prev(this->container.end());
-				travOther = other.container.prev(other.container.end());
-				stopHere = this->container.prev(this->container.begin());
-				while(travThis != stopHere){
-					if(*travThis < *travOther)
-						return (this->sign? 1: 0);
-					else if(*travOther < *travThis)
-						return (this->sign? 0: 1);
-					--travThis;
-					--travOther;
-				}
-			}
-		}
-		else{
-			if(this->direction){
-				travThis = this->container.begin();	
-				travOther = other.container.prev(other.container.end());
-				stopHere = this->container.end();
-				while(travThis != stopHere){
-					if(*travThis < *travOther)
-						return (this->sign? 1: 0);
-					else if(*travOther < *travThis)
-						return (this->sign? 0: 1);
-					++travThis;
-					--travOther;
-				}
-			}
-			else{
-				travThis = this->container.prev(this->container.end());	
-				travOther = other.container.begin();
-				stopHere = this->container.prev(this->container.begin());
-				while(travThis != stopHere){
-					if(*travThis < *travOther)
-						return (this->sign? 1: 0);
-					else if(*travOther < *travThis)
-						return (this->sign? 0: 1);
-					--travThis;
-					++travOther;
-				}
-			}
-		}
-		return false;
-	}	
-}
\ No newline at end of file
+	return compare(other) < 0;
+}
+
+template <typename T, template <typename> typename C>
+bool BigInt<T,C>::operator>=(const BigInt<T,C> &other) const noexcept{
+	return compare(other) >= 0;
+}
+
+template <typename T, template <typename> typename C>
+bool BigInt<T,C>::operator<=(const BigInt<T,C> &other) const noexcept{
+	return compare(other) <= 0;
+}
+
+#if __cplusplus >= 202002L
+template <typename T, template <typename> typename C>
+strong_ordering BigInt<T,C>::operator<=>(const BigInt<T,C> &other) const noexcept{
+	return compare(other) <=> 0;
+}
+#endif
+
+/////////////////////////// BUILT-IN INTEGERS ///////////////////////////////////
+
+/* The operators below take a built-in integer as it is: its magnitude
+ * (up to 128 bits) is split into a few limbs on the stack, never into a
+ * BigInt of its own. Adding or subtracting works in place on the limbs the
+ * carry reaches, and a one-limb factor or divisor takes a single pass over
+ * the limbs; values that fit in 128 bits are computed natively.
+ */
+
+template <typename T, template <typename> typename C>
+template <typename I, EnableIfNative<I>>
+const BigInt<T,C>& BigInt<T,C>::operator=(I value){
+	assignNative(nativeMagnitude(value), !(value < I(0)));
+	return *this;
+}
+
+template <typename T, template <typename> typename C>
+template <typename I, EnableIfNative<I>>
+BigInt<T,C> BigInt<T,C>::operator+(I value) const{
+	BIGINT_STAT_SCOPE(STAT_ADD, count);
+	BigInt<T,C> returner(*this);
+	returner += value;
+	return returner;
+}
+
+template <typename T, template <typename> typename C>
+template <typename I, EnableIfNative<I>>
+BigInt<T,C> BigInt<T,C>::operator-(I value) const{
+	BIGINT_STAT_SCOPE(STAT_SUB, count);
+	BigInt<T,C> returner(*this);
+	returner -= value;
+	return returner;
+}
+
+template <typename T, template <typename> typename C>
+template <typename I, EnableIfNative<I>>
+BigInt<T,C> BigInt<T,C>::operator*(I value) const{
+	BigInt<T,C> returner(*this);
+	returner *= value;
+	return returner;
+}
+
+template <typename T, template <typename> typename C>
+template <typename I, EnableIfNative<I>>
+BigInt<T,C> BigInt<T,C>::operator/(I value) const{
+	BigInt<T,C> returner(*this);
+	returner /= value;
+	return returner;
+}
+
+//the remainder takes the sign of 'this', like the built-in types
+template <typename T, template <typename> typename C>
+template <typename I, EnableIfNative<I>>
+BigInt<T,C> BigInt<T,C>::operator%(I value) const{
+	BIGINT_STAT_SCOPE(STAT_DIVMOD, count);
+	Native divisor = nativeMagnitude(value);
+	if(divisor == 0)
+		throw domain_error("BigInt::operator%: error! tried dividing by zero");
+	BigInt<T,C> returner;
+	returner.assignNative(remainderNative(divisor), sign);
+	return returner;
+}
+
+template <typename T, template <typename> typename C>
+template <typename I, EnableIfNative<I>>
+BigInt<T,C>& BigInt<T,C>::operator+=(I value){
+	accumulateNative(nativeMagnitude(value), !(value < I(0)));
+	return *this;
+}
+
+template <typename T, template <typename> typename C>
+template <typename I, EnableIfNative<I>>
+BigInt<T,C>& BigInt<T,C>::operator-=(I value){
+	accumulateNative(nativeMagnitude(value), value < I(0));
+	return *this;
+}
+
+template <typename T, template <typename> typename C>
+template <typename I, EnableIfNative<I>>
+BigInt<T,C>& BigInt<T,C>::operator*=(I value){
+	BIGINT_STAT_SCOPE(STAT_MUL, count);
+	multiplyNative(nativeMagnitude(value), sign == !(value < I(0)));
+	return *this;
+}
+
+template <typename T, template <typename> typename C>
+template <typename I, EnableIfNative<I>>
+BigInt<T,C>& BigInt<T,C>::operator/=(I value){
+	BIGINT_STAT_SCOPE(STAT_DIVMOD, count);
+	Native divisor = nativeMagnitude(value);
+	if(divisor == 0)
+		throw domain_error("BigInt::operator/=: error! tried dividing by zero");
+	divideNative(divisor, sign == !(value < I(0)));
+	return *this;
+}
+
+template <typename T, template <typename> typename C>
+template <typename I, EnableIfNative<I>>
+BigInt<T,C>& BigInt<T,C>::operator%=(I value){
+	BIGINT_STAT_SCOPE(STAT_DIVMOD, count);
+	Native divisor = nativeMagnitude(value);
+	if(divisor == 0)
+		throw domain_error("BigInt::operator%=: error! tried dividing by zero");
+	assignNative(remainderNative(divisor), sign);
+	return *this;
+}
+
+template <typename T, template <typename> typename C>
+BigInt<T,C>& BigInt<T,C>::operator++(){
+	accumulateNative(1, true);
+	return *this;
+}
+
+template <typename T, template <typename> typename C>
+BigInt<T,C> BigInt<T,C>::operator++(int){
+	BigInt<T,C> returner(*this);
+	accumulateNative(1, true);
+	return returner;
+}
+
+template <typename T, template <typename> typename C>
+BigInt<T,C>& BigInt<T,C>::operator--(){
+	accumulateNative(1, false);
+	return *this;
+}
+
+template <typename T, template <typename> typename C>
+BigInt<T,C> BigInt<T,C>::operator--(int){
+	BigInt<T,C> returner(*this);
+	accumulateNative(1, false);
+	return returner;
+}
+
+//-1, 0 or 1 as the value is below, equal to or above 'value'
+template <typename T, template <typename> typename C>
+template <typename I, EnableIfNative<I>>
+int BigInt<T,C>::compare(I value) const noexcept{
+	return compareNative(nativeMagnitude(value), !(value < I(0)));
+}
+
+template <typename T, template <typename> typename C>
+template <typename I, EnableIfNative<I>>
+bool BigInt<T,C>::operator==(I value) const noexcept{
+	return compare(value) == 0;
+}
+
+template <typename T, template <typename> typename C>
+template <typename I, EnableIfNative<I>>
+bool BigInt<T,C>::operator!=(I value) const noexcept{
+	return compare(value) != 0;
+}
+
+template <typename T, template <typename> typename C>
+template <typename I, EnableIfNative<I>>
+bool BigInt<T,C>::operator>(I value) const noexcept{
+	return compare(value) > 0;
+}
+
+template <typename T, template <typename> typename C>
+template <typename I, EnableIfNative<I>>
+bool BigInt<T,C>::operator<(I value) const noexcept{
+	return compare(value) < 0;
+}
+
+template <typename T, template <typename> typename C>
+template <typename I, EnableIfNative<I>>
+bool BigInt<T,C>::operator>=(I value) const noexcept{
+	return compare(value) >= 0;
+}
+
+template <typename T, template <typename> typename C>
+template <typename I, EnableIfNative<I>>
+bool BigInt<T,C>::operator<=(I value) const noexcept{
+	return compare(value) <= 0;
+}
+
+#if __cplusplus >= 202002L
+template <typename T, template <typename> typename C>
+template <typename I, EnableIfNative<I>>
+strong_ordering BigInt<T,C>::operator<=>(I value) const noexcept{
+	return compare(value) <=> 0;
+}
+#endif
+
+//the same operators with the built-in integer on the left
+template <typename I, typename T, template <typename> typename C, EnableIfNative<I> = 0>
+BigInt<T,C> operator+(I value, const BigInt<T,C> &bigint){
+	return bigint + value;
+}
+
+//value - bigint is -(bigint - value)
+template <typename I, typename T, template <typename> typename C, EnableIfNative<I> = 0>
+BigInt<T,C> operator-(I value, const BigInt<T,C> &bigint){
+	BigInt<T,C> returner = bigint - value;
+	returner.negate();
+	return returner;
+}
+
+template <typename I, typename T, template <typename> typename C, EnableIfNative<I> = 0>
+BigInt<T,C> operator*(I value, const BigInt<T,C> &bigint){
+	return bigint * value;
+}
+
+//a divisor wider than 128 bits is larger than any built-in integer, so the quotient is 0
+template <typename I, typename T, template <typename> typename C, EnableIfNative<I>>
+BigInt<T,C> operator/(I value, const BigInt<T,C> &bigint){
+	BIGINT_STAT_SCOPE(STAT_DIVMOD, bigint.count);
+	if(bigint.count == 0)
+		throw domain_error("BigInt::operator/: error! tried dividing by zero");
+	BigInt<T,C> returner;
+	typename BigInt<T,C>::Native divisor;
+	if(bigint.toNative(divisor))
+		returner.assignNative(BigInt<T,C>::nativeMagnitude(value) / divisor, !(value < I(0)) == bigint.sign);
+	return returner;
+}
+
+//the remainder takes the sign of 'value', and is 'value' itself when the divisor is wider than 128 bits
+template <typename I, typename T, template <typename> typename C, EnableIfNative<I>>
+BigInt<T,C> operator%(I value, const BigInt<T,C> &bigint){
+	BIGINT_STAT_SCOPE(STAT_DIVMOD, bigint.count);
+	if(bigint.count == 0)
+		throw domain_error("BigInt::operator%: error! tried dividing by zero");
+	BigInt<T,C> returner;
+	typename BigInt<T,C>::Native divisor, dividend = BigInt<T,C>::nativeMagnitude(value);
+	returner.assignNative(bigint.toNative(divisor)? dividend % divisor: dividend, !(value < I(0)));
+	return returner;
+}
+
+template <typename I, typename T, template <typename> typename C, EnableIfNative<I> = 0>
+bool operator==(I value, const BigInt<T,C> &bigint) noexcept{
+	return bigint.compare(value) == 0;
+}
+
+template <typename I, typename T, template <typename> typename C, EnableIfNative<I> = 0>
+bool operator!=(I value, const BigInt<T,C> &bigint) noexcept{
+	return bigint.compare(value) != 0;
+}
+
+template <typename I, typename T, template <typename> typename C, EnableIfNative<I> = 0>
+bool operator<(I value, const BigInt<T,C> &bigint) noexcept{
+	return bigint.compare(value) > 0;
+}
+
+template <typename I, typename T, template <typename> typename C, EnableIfNative<I> = 0>
+bool operator>(I value, const BigInt<T,C> &bigint) noexcept{
+	return bigint.compare(value) < 0;
+}
+
+template <typename I, typename T, template <typename> typename C, EnableIfNative<I> = 0>
+bool operator<=(I value, const BigInt<T,C> &bigint) noexcept{
+	return bigint.compare(value) >= 0;
+}
+
+template <typename I, typename T, template <typename> typename C, EnableIfNative<I> = 0>
+bool operator>=(I value, const BigInt<T,C> &bigint) noexcept{
+	return bigint.compare(value) <= 0;
+}
+
+/////////////////////////// HASHING ///////////////////////////////////
+
+//so that BigInts can be the keys of unordered_map and unordered_set; see BigInt::hash
+namespace std{
+template <typename T, template <typename> typename C>
+struct hash<BigInt<T,C>>{
+	size_t operator()(const BigInt<T,C> &bigint) const noexcept{
+		return bigint.hash();
+	}
+};
+}
+
+#endif
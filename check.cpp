@@ -0,0 +1,858 @@
+#include "bigint.h"
+#include "mapped.h"
+#include <random>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+#include <unordered_set>
+#include <limits>
+#include <vector>
+#include <fstream>
+
+/* Self-checking regression tests for the kernels whose fast paths only run
+ * on large operands. The thresholds are lowered so that small random
+ * operands go through Karatsuba, Toom-3, the NTT and Burnikel-Ziegler, the
+ * parallel carry/borrow blocks and the parallel multiplication, and every
+ * SIMD level the machine has is tried in turn. Each result is compared with
+ * the plain kernels: schoolbook multiplication, Knuth's division, and a
+ * limb by limb addition and subtraction written out below.
+ *
+ * For every container, with a spread of limb types, the BigInt operators,
+ * their assignments (x op= x included), compare() and the relational
+ * operators, the ones mixing in a built-in integer on either side, parse()
+ * and operator<< (through the radix conversions for binary limbs, whose
+ * thresholds are lowered too) and MappedFile are compared with Decimal, a
+ * number worked on one decimal digit at a time. Given the path of
+ * batch.out, it runs it on records with broken ones mixed in, and checks
+ * the order and text of its output lines. Serialized
+ * input whose checksum matches but whose limbs no BigInt could hold is
+ * checked to be turned down, and so is an allocation past a MemoryBudget; a
+ * ChunkedList copy cut short that way must leave its target untouched. A
+ * copy whose sign is then changed must not keep the hash it was copied with,
+ * and text that parse() turns down must not change the value it was read into.
+ *
+ * Build and run it with 'make check'; it prints one line per group of
+ * checks and exits with a nonzero status if any of them failed.
+ */
+
+using namespace std;
+
+const size_t ROUNDS = 300; //random operands per limb type and check
+
+mt19937_64 gen(12345);
+size_t failures = 0;
+
+void expect(bool ok, const char *what, const char *type, size_t na, size_t nb){
+	if(ok)
+		return;
+	if(++failures <= 20)
+		fprintf(stderr, "FAILED %s for %s, sizes %zu and %zu\n", what, type, na, nb);
+}
+
+//n limbs in [0, BASE); 'pattern' 1 makes them all BASE-1, 2 all 0, so carries and borrows run the whole way
+template <typename T>
+void randomLimbs(Vector<T> &limbs, size_t n, int pattern = 0){
+	typedef LimbTraits<T> Traits;
+	limbs = Vector<T>(n);
+	for(size_t i = 0; i < n; i++){
+		if(pattern == 1)
+			limbs[i] = T(Traits::BASE - 1);
+		else if(pattern == 2)
+			limbs[i] = 0;
+		else
+			limbs[i] = T(typename Traits::Wide(gen()) % Traits::BASE);
+	}
+}
+
+//a size that is small most of the time, so both short and long operands come up
+size_t randomSize(size_t most){
+	size_t size = gen() % (most + 1);
+	return (gen() % 4 == 0? size: size / 4);
+}
+
+//r = a + b + carry one limb at a time, the reference for the SIMD and parallel additions
+template <typename T>
+T referenceAdd(T *r, const T *a, const T *b, size_t n, T carry){
+	typedef LimbTraits<T> Traits;
+	for(size_t i = 0; i < n; i++){
+		typename Traits::Wide sum = typename Traits::Wide(a[i]) + b[i] + carry;
+		carry = (sum >= Traits::BASE);
+		r[i] = T(carry? sum - Traits::BASE: sum);
+	}
+	return carry;
+}
+
+template <typename T>
+T referenceSub(T *r, const T *a, const T *b, size_t n, T borrow){
+	typedef LimbTraits<T> Traits;
+	for(size_t i = 0; i < n; i++){
+		typename Traits::Wide minuend = a[i], subtrahend = typename Traits::Wide(b[i]) + borrow;
+		borrow = (minuend < subtrahend);
+		r[i] = T((borrow? minuend + Traits::BASE: minuend) - subtrahend);
+	}
+	return borrow;
+}
+
+template <typename T>
+bool sameLimbs(const Vector<T> &a, const Vector<T> &b){
+	return a.size() == b.size() && equal(a.begin(), a.end(), b.begin());
+}
+
+//simdAddN, simdSubN, simdCompare and simdEqual at the current SIMD level, and parallelAddN/parallelSubN
+template <typename T>
+void checkCarries(const char *type){
+	Vector<T> a, b, expected(0), result(0);
+	for(size_t round = 0; round < ROUNDS; round++){
+		size_t n = randomSize(300);
+		int pattern = int(round % 3);
+		randomLimbs(a, n, pattern == 0? 0: (pattern == 1? 1: 2));
+		randomLimbs(b, n);
+		if(pattern != 0 && n > 0){ //one limb starts a carry (borrow) that runs through all the others
+			fill(b.begin(), b.end(), T(0));
+			b[gen() % n] = 1;
+		}
+		T in = T(gen() % 2);
+		expected = Vector<T>(n);
+		result = Vector<T>(n);
+		T out = referenceAdd(expected.begin(), a.begin(), b.begin(), n, in);
+		expect(simdAddN(result.begin(), a.begin(), b.begin(), n, in) == out && sameLimbs(expected, result),
+			   "simdAddN", type, n, n);
+		expect(parallelAddN(result.begin(), a.begin(), b.begin(), n, in) == out && sameLimbs(expected, result),
+			   "parallelAddN", type, n, n);
+		out = referenceSub(expected.begin(), a.begin(), b.begin(), n, in);
+		expect(simdSubN(result.begin(), a.begin(), b.begin(), n, in) == out && sameLimbs(expected, result),
+			   "simdSubN", type, n, n);
+		expect(parallelSubN(result.begin(), a.begin(), b.begin(), n, in) == out && sameLimbs(expected, result),
+			   "parallelSubN", type, n, n);
+		Vector<T> c(a);
+		int order = 0;
+		if(n > 0 && gen() % 2 == 0){
+			size_t limb = gen() % n;
+			c[limb] = T(c[limb] == 0? 1: c[limb] - 1);
+			order = (c[limb] < a[limb]? 1: -1);
+		}
+		expect(simdCompare(a.begin(), c.begin(), n) == order, "simdCompare", type, n, n);
+		expect(simdEqual(a.begin(), c.begin(), n) == (order == 0), "simdEqual", type, n, n);
+	}
+}
+
+//limbMul against limbMulSchoolbook, and limbDivmod against limbDivmodSchoolbook
+template <typename T>
+void checkProducts(const char *type){
+	Vector<T> a, b;
+	for(size_t round = 0; round < ROUNDS; round++){
+		size_t na = randomSize(400) + 1, nb = randomSize(400) + 1;
+		randomLimbs(a, na, round % 7 == 0? 1: 0);
+		randomLimbs(b, nb, round % 5 == 0? 1: 0);
+		Vector<T> expected(na + nb), result(na + nb);
+		limbMulSchoolbook(expected.begin(), a.begin(), na, b.begin(), nb);
+		limbMul(result.begin(), a.begin(), na, b.begin(), nb);
+		expect(sameLimbs(expected, result), "limbMul", type, na, nb);
+
+		if(na < nb){ //the dividend is the longer one
+			swap(a, b);
+			swap(na, nb);
+		}
+		if(b[nb - 1] == 0)
+			b[nb - 1] = 1;
+		Vector<T> q(na - nb + 1), r(nb), qExpected(na - nb + 1), rExpected(nb);
+		limbDivmodSchoolbook(qExpected.begin(), rExpected.begin(), a.begin(), na, b.begin(), nb);
+		limbDivmod(q.begin(), r.begin(), a.begin(), na, b.begin(), nb);
+		expect(sameLimbs(qExpected, q) && sameLimbs(rExpected, r), "limbDivmod", type, na, nb);
+	}
+}
+
+template <typename T>
+void checkType(const char *type){
+	SimdLevel detected = simdDetect();
+	for(int level = SIMD_SCALAR; level <= detected; level++){
+		simdLevel() = static_cast<SimdLevel>(level);
+		checkCarries<T>(type);
+		checkProducts<T>(type);
+	}
+	simdLevel() = detected;
+}
+
+//a serialized BigInt of int limbs with the given count and limb bytes, whose checksum matches them
+string serialBytes(uint64_t count, const string &limbs){
+	char header[SERIAL_HEADER];
+	serialStoreHeader(header, {true, sizeof(int), false, count, serialChecksum(limbs.data(), limbs.size())});
+	return string(header, SERIAL_HEADER) + limbs;
+}
+
+//whether both deserialize and readBinary turn 'bytes' down
+bool rejected(const string &bytes){
+	BigInt<int,Vector> number;
+	size_t turnedDown = 0;
+	try{
+		number.deserialize(bytes.data(), bytes.size());
+	}catch(invalid_argument&){
+		++turnedDown;
+	}
+	try{
+		istringstream in(bytes);
+		number.readBinary(in);
+	}catch(invalid_argument&){
+		++turnedDown;
+	}
+	return turnedDown == 2;
+}
+
+//serialized input whose checksum matches, but which no BigInt could have written
+void checkSerialization(){
+	const int LIMBS[][2] = {{1000000000, 1}, {-5, 1}, {5, 0}}; //a limb of BASE, a negative one, a top limb of 0
+	for(const int *limbs: LIMBS)
+		expect(rejected(serialBytes(2, string(reinterpret_cast<const char*>(limbs), 2 * sizeof(int)))),
+			   "serialized limbs", "int", 2, 0);
+	expect(rejected(serialBytes(uint64_t(1) << 62, string(64, '\1'))), "serialized count", "int", 0, 0);
+	expect(rejected(serialBytes(uint64_t(1) << 40, string(64, '\1'))), "serialized count", "int", 0, 0);
+}
+
+/////////////////////////// REFERENCE ////////////////////////////////////
+
+//a number kept as its decimal digits, worked on one digit at a time; the reference BigInts are checked against
+struct Decimal{
+	bool negative;
+	string digits; //most significant first, no leading 0's, "0" for 0
+};
+
+Decimal decimal(const string &text){
+	size_t first = (!text.empty() && (text[0] == '-' || text[0] == '+'));
+	size_t nonzero = text.find_first_not_of('0', first);
+	Decimal number{text[0] == '-', nonzero == string::npos? "0": text.substr(nonzero)};
+	number.negative = number.negative && number.digits != "0";
+	return number;
+}
+
+string text(const Decimal &number){
+	return (number.negative? "-": "") + number.digits;
+}
+
+//the text a BigInt prints, without the blank in front of a positive value
+template <typename Number>
+string text(const Number &number){
+	ostringstream out;
+	out << number;
+	string printed = out.str();
+	return (printed[0] == ' '? printed.substr(1): printed);
+}
+
+template <typename I>
+string nativeText(I value){
+	unsigned __int128 magnitude = (value < I(0)? -static_cast<unsigned __int128>(value): static_cast<unsigned __int128>(value));
+	string digits;
+	do{
+		digits.insert(digits.begin(), char('0' + int(magnitude % 10)));
+		magnitude /= 10;
+	}while(magnitude > 0);
+	return (value < I(0)? "-": "") + digits;
+}
+
+int compareDigits(const string &a, const string &b){
+	if(a.size() != b.size())
+		return (a.size() < b.size()? -1: 1);
+	int order = a.compare(b);
+	return (order < 0? -1: (order > 0? 1: 0));
+}
+
+string trimDigits(string digits){
+	size_t nonzero = digits.find_first_not_of('0');
+	return (nonzero == string::npos? "0": digits.substr(nonzero));
+}
+
+string addDigits(const string &a, const string &b){
+	string sum(max(a.size(), b.size()) + 1, '0');
+	int carry = 0;
+	for(size_t i = 0; i < sum.size(); i++){
+		int digit = carry + (i < a.size()? a[a.size() - 1 - i] - '0': 0) + (i < b.size()? b[b.size() - 1 - i] - '0': 0);
+		carry = digit / 10;
+		sum[sum.size() - 1 - i] = char('0' + digit % 10);
+	}
+	return trimDigits(sum);
+}
+
+//a - b, for a >= b
+string subDigits(const string &a, const string &b){
+	string difference(a);
+	int borrow = 0;
+	for(size_t i = 0; i < a.size(); i++){
+		int digit = (a[a.size() - 1 - i] - '0') - borrow - (i < b.size()? b[b.size() - 1 - i] - '0': 0);
+		borrow = (digit < 0);
+		difference[a.size() - 1 - i] = char('0' + digit + 10 * borrow);
+	}
+	return trimDigits(difference);
+}
+
+string mulDigits(const string &a, const string &b){
+	vector<int> product(a.size() + b.size(), 0);
+	for(size_t i = 0; i < a.size(); i++)
+		for(size_t j = 0; j < b.size(); j++)
+			product[i + j + 1] += (a[i] - '0') * (b[j] - '0');
+	string digits(product.size(), '0');
+	int carry = 0;
+	for(size_t k = product.size(); k-- > 0;){
+		int digit = product[k] + carry;
+		carry = digit / 10;
+		digits[k] = char('0' + digit % 10);
+	}
+	return trimDigits(digits);
+}
+
+//long division, one quotient digit at a time
+void divDigits(const string &a, const string &b, string &quotient, string &remainder){
+	quotient.assign(a.size(), '0');
+	remainder = "0";
+	for(size_t i = 0; i < a.size(); i++){
+		remainder = trimDigits(remainder + a[i]);
+		while(compareDigits(remainder, b) >= 0){
+			remainder = subDigits(remainder, b);
+			++quotient[i];
+		}
+	}
+	quotient = trimDigits(quotient);
+}
+
+Decimal operator-(Decimal a){
+	a.negative = !a.negative && a.digits != "0";
+	return a;
+}
+
+Decimal operator+(const Decimal &a, const Decimal &b){
+	if(a.negative == b.negative)
+		return decimal((a.negative? "-": "") + addDigits(a.digits, b.digits));
+	bool flip = compareDigits(a.digits, b.digits) < 0;
+	string digits = (flip? subDigits(b.digits, a.digits): subDigits(a.digits, b.digits));
+	return decimal(((flip? b.negative: a.negative)? "-": "") + digits);
+}
+
+Decimal operator-(const Decimal &a, const Decimal &b){
+	return a + -b;
+}
+
+Decimal operator*(const Decimal &a, const Decimal &b){
+	return decimal((a.negative != b.negative? "-": "") + mulDigits(a.digits, b.digits));
+}
+
+//rounded towards 0, with the remainder taking the sign of 'a', like the built-in types
+Decimal operator/(const Decimal &a, const Decimal &b){
+	string quotient, remainder;
+	divDigits(a.digits, b.digits, quotient, remainder);
+	return decimal((a.negative != b.negative? "-": "") + quotient);
+}
+
+Decimal operator%(const Decimal &a, const Decimal &b){
+	string quotient, remainder;
+	divDigits(a.digits, b.digits, quotient, remainder);
+	return decimal((a.negative? "-": "") + remainder);
+}
+
+int compare(const Decimal &a, const Decimal &b){
+	if(a.negative != b.negative)
+		return (a.negative? -1: 1);
+	int order = compareDigits(a.digits, b.digits);
+	return (a.negative? -order: order);
+}
+
+//'digits' random digits (at least one), the first of them nonzero
+string randomDigits(size_t digits){
+	string text(max(digits, size_t(1)), '0');
+	for(char &digit: text)
+		digit = char('0' + gen() % 10);
+	text[0] = char('1' + gen() % 9);
+	return text;
+}
+
+//a random value of up to 'most' digits, of either sign, and now and then 0
+Decimal randomDecimal(size_t most){
+	if(gen() % 16 == 0)
+		return decimal("0");
+	return decimal((gen() % 2? "-": "") + randomDigits(randomSize(most) + 1));
+}
+
+template <typename Number>
+Number number(const Decimal &value){
+	string digits = text(value);
+	Number returner;
+	returner.parse(digits.data(), digits.size());
+	return returner;
+}
+
+//names a Number type for the generic lambdas of forEachNumber
+template <typename Number>
+struct Tag{
+	typedef Number type;
+};
+
+/////////////////////////// BUILT-IN INTEGERS ///////////////////////////////
+
+//the operators that take a built-in integer on either side, and their assignments, against the reference
+template <typename Number, typename I>
+void checkNativeWith(const Decimal &a, I value, const char *type){
+	Number x = number<Number>(a);
+	Decimal b = decimal(nativeText(value));
+	size_t na = a.digits.size(), nb = b.digits.size();
+	expect(text(x + value) == text(a + b) && text(value + x) == text(a + b), "BigInt + integer", type, na, nb);
+	expect(text(x - value) == text(a - b) && text(value - x) == text(b - a), "BigInt - integer", type, na, nb);
+	expect(text(x * value) == text(a * b) && text(value * x) == text(a * b), "BigInt * integer", type, na, nb);
+	expect(x.compare(value) == compare(a, b) && (x < value) == (compare(a, b) < 0) && (value < x) == (compare(b, a) < 0),
+		   "BigInt compared with an integer", type, na, nb);
+	if(b.digits != "0"){
+		expect(text(x / value) == text(a / b) && text(x % value) == text(a % b), "BigInt / integer", type, na, nb);
+		Number quotient(x), remainder(x);
+		quotient /= value;
+		remainder %= value;
+		expect(text(quotient) == text(a / b) && text(remainder) == text(a % b), "BigInt /= integer", type, na, nb);
+	}
+	if(a.digits != "0")
+		expect(text(value / x) == text(b / a) && text(value % x) == text(b % a), "integer / BigInt", type, na, nb);
+	Number sum(x), difference(x), product(x);
+	sum += value;
+	difference -= value;
+	product *= value;
+	expect(text(sum) == text(a + b) && text(difference) == text(a - b) && text(product) == text(a * b),
+		   "BigInt += integer", type, na, nb);
+}
+
+//a random value of a built-in type, mostly spread over its whole range, sometimes at one of its ends
+template <typename I>
+I randomNative(){
+	unsigned __int128 bits = (static_cast<unsigned __int128>(gen()) << 64) | gen();
+	switch(gen() % 8){
+		case 0: return numeric_limits<I>::min();
+		case 1: return numeric_limits<I>::max();
+		case 2: return I(gen() % 3) - I(1);
+		default: return static_cast<I>(bits >> (gen() % 128));
+	}
+}
+
+template <typename Number>
+void checkNative(const char *type){
+	for(size_t round = 0; round < ROUNDS; round++){
+		Decimal a = randomDecimal(round % 2? 40: 120); //most of the time within 128 bits, otherwise past them
+		checkNativeWith<Number>(a, randomNative<int>(), type);
+		checkNativeWith<Number>(a, randomNative<unsigned>(), type);
+		checkNativeWith<Number>(a, randomNative<long long>(), type);
+		checkNativeWith<Number>(a, randomNative<unsigned long long>(), type);
+		checkNativeWith<Number>(a, randomNative<__int128>(), type);
+		checkNativeWith<Number>(a, randomNative<unsigned __int128>(), type);
+	}
+}
+
+/////////////////////////// ARITHMETIC ////////////////////////////////////
+
+//a value for the right hand side that is often related to 'a': equal, opposite, or one digit off
+Decimal relatedDecimal(const Decimal &a, size_t most){
+	switch(gen() % 6){
+		case 0: return a;
+		case 1: return -a;
+		case 2:{
+			Decimal b = a;
+			char &digit = b.digits[gen() % b.digits.size()];
+			digit = char(digit == '9'? '8': digit + 1);
+			return b;
+		}
+		default: return randomDecimal(most);
+	}
+}
+
+//the BigInt operators, assignments and comparisons against the reference, 'x op= x' included
+template <typename Number>
+void checkArithmetic(const char *type){
+	for(size_t round = 0; round < ROUNDS / 3; round++){
+		Decimal a = randomDecimal(200), b = relatedDecimal(a, 200);
+		Number x = number<Number>(a), y = number<Number>(b);
+		size_t na = a.digits.size(), nb = b.digits.size();
+		expect(text(x + y) == text(a + b) && text(x - y) == text(a - b) && text(x * y) == text(a * b), "+ - *", type, na, nb);
+		if(b.digits != "0"){
+			Number quotient, remainder;
+			x.divmod(y, quotient, remainder);
+			expect(text(x / y) == text(a / b) && text(x % y) == text(a % b) &&
+				   text(quotient) == text(a / b) && text(remainder) == text(a % b), "/ %", type, na, nb);
+		}
+		int order = compare(a, b);
+		expect(x.compare(y) == order && (x < y) == (order < 0) && (x > y) == (order > 0) &&
+			   (x <= y) == (order <= 0) && (x >= y) == (order >= 0) && (x == y) == (order == 0) && (x != y) == (order != 0),
+			   "compare", type, na, nb);
+
+		Number sum(x), difference(x), product(x);
+		sum += y;
+		difference -= y;
+		product *= y;
+		expect(text(sum) == text(a + b) && text(difference) == text(a - b) && text(product) == text(a * b), "+= -= *=", type, na, nb);
+		Number twice(x), none(x), square(x);
+		twice += twice;
+		none -= none;
+		square *= square;
+		expect(text(twice) == text(a + a) && text(none) == "0" && text(square) == text(a * a), "x += x, x -= x, x *= x", type, na, na);
+		if(a.digits != "0"){
+			Number one(x), zero(x);
+			one /= one;
+			zero %= zero;
+			expect(text(one) == "1" && text(zero) == "0", "x /= x, x %= x", type, na, na);
+		}
+	}
+}
+
+/////////////////////////// TEXT ////////////////////////////////////////////
+
+//parse() and operator<< give back the text they were handed, with its sign and leading 0's tidied up
+template <typename Number>
+void checkText(const char *type){
+	for(size_t round = 0; round < ROUNDS / 3; round++){
+		Decimal a = randomDecimal(round % 10 == 0? 3000: 300);
+		string line = (a.negative? "-": (gen() % 2? "+": "")) + string(gen() % 3, '0') + a.digits + (gen() % 4 == 0? "\r": "");
+		Number x;
+		x.parse(line.data(), line.size());
+		Number y = number<Number>(decimal(text(x)));
+		expect(text(x) == text(a) && y == x && y.hash() == x.hash(), "parse and print", type, a.digits.size(), 0);
+	}
+}
+
+//MappedFile reads each line as a BigInt, and an operator as the first character of its line
+template <typename Number>
+void checkMappedFile(const char *type){
+	char path[] = "/tmp/checkXXXXXX";
+	int descriptor = mkstemp(path);
+	if(descriptor < 0){
+		expect(false, "MappedFile (no temporary file)", type, 0, 0);
+		return;
+	}
+	vector<Decimal> values;
+	string contents, operators = "+-*/%<>";
+	for(size_t i = 0; i < 50; i++){
+		values.push_back(randomDecimal(100));
+		contents += text(values.back()) + (i % 7 == 0? "\r\n": "\n");
+		contents += string(i % 3, ' ') + operators[i % operators.size()] + "\n";
+	}
+	contents.pop_back(); //the last line may end without a '\n'
+	expect(write(descriptor, contents.data(), contents.size()) == ssize_t(contents.size()), "MappedFile (write)", type, 0, 0);
+	close(descriptor);
+	MappedFile file(path);
+	for(size_t i = 0; i < values.size(); i++){
+		Number x;
+		char symbol = 0;
+		file >> x >> symbol;
+		expect(text(x) == text(values[i]) && symbol == operators[i % operators.size()], "MappedFile", type, values[i].digits.size(), i);
+	}
+	Number past;
+	bool thrown = false;
+	try{
+		file >> past;
+	}catch(NoSuchObject&){
+		thrown = true;
+	}
+	expect(file.eof() && thrown, "MappedFile at its end", type, 0, 0);
+	unlink(path);
+}
+
+//runs each check for every container, with a spread of limb types
+template <typename F>
+void forEachNumber(F check){
+	check(Tag<BigInt<int,Vector>>(), "int,Vector");
+	check(Tag<BigInt<unsigned long long,Vector>>(), "unsigned long long,Vector");
+	check(Tag<BigInt<long long,SmallVector>>(), "long long,SmallVector");
+	check(Tag<BigInt<unsigned,SmallVector>>(), "unsigned,SmallVector");
+	check(Tag<BigInt<char,List>>(), "char,List");
+	check(Tag<BigInt<unsigned,List>>(), "unsigned,List");
+	check(Tag<BigInt<short,ArenaList>>(), "short,ArenaList");
+	check(Tag<BigInt<unsigned short,ThreadList>>(), "unsigned short,ThreadList");
+	check(Tag<BigInt<unsigned char,ChunkedList>>(), "unsigned char,ChunkedList");
+	check(Tag<BigInt<int,ChunkedList>>(), "int,ChunkedList");
+}
+
+/////////////////////////// BATCH ///////////////////////////////////////////
+
+//what batch.out prints for a value: positive ones after a blank, like operator<<
+string printed(const Decimal &value){
+	return (value.digits == "0" || value.negative? "": " ") + text(value);
+}
+
+//a records file for batch.out, more than a few batches long, with broken records mixed in; 'expected' gets its output
+string batchRecords(vector<string> &expected){
+	const char *const OPERATORS[] = {"+", "-", "*", "/", "%", "<", ">", "==", "!="};
+	string records;
+	for(size_t i = 0; i < 2000; i++){
+		Decimal a = randomDecimal(60), b = relatedDecimal(a, 60);
+		string op = OPERATORS[gen() % 9], first = text(a), second = text(b);
+		string result;
+		switch(gen() % 40){
+			case 0: first += "x"; result = "error: BigInt::parse: error! tried reading a non-digit character"; break;
+			case 1: op = "+-"; result = "error: unknown operator '+-'"; break;
+			case 2: op = "="; result = "error: unknown operator '='"; break;
+			case 3: second = "0"; op = "/"; result = "error: BigInt::divmod: error! tried dividing by zero"; break;
+			default:
+				b = decimal(second);
+				if((op == "/" || op == "%") && b.digits == "0")
+					op = "*";
+				switch(op[0]){
+					case '+': result = printed(a + b); break;
+					case '-': result = printed(a - b); break;
+					case '*': result = printed(a * b); break;
+					case '/': result = printed(a / b); break;
+					case '%': result = printed(a % b); break;
+					case '<': result = (compare(a, b) < 0? "1": "0"); break;
+					case '>': result = (compare(a, b) > 0? "1": "0"); break;
+					case '=': result = (compare(a, b) == 0? "1": "0"); break;
+					case '!': result = (compare(a, b) != 0? "1": "0"); break;
+				}
+		}
+		records += first + "\n" + (gen() % 5 == 0? "\n  \n": "") + second + "\n" + (gen() % 5 == 0? " ": "") + op + "\n";
+		expected.push_back(result);
+	}
+	records += "12345\n"; //a record the input ends in the middle of
+	expected.push_back("error: the input ended in the middle of a record");
+	return records;
+}
+
+//batch.out prints one line per record, in input order, with an error line for each broken one
+void checkBatch(const char *program){
+	vector<string> expected;
+	string records = batchRecords(expected);
+	char input[] = "/tmp/checkXXXXXX", output[] = "/tmp/checkXXXXXX";
+	int in = mkstemp(input), out = mkstemp(output);
+	if(in < 0 || out < 0){
+		expect(false, "batch.out (no temporary file)", "int", 0, 0);
+		return;
+	}
+	expect(write(in, records.data(), records.size()) == ssize_t(records.size()), "batch.out (write)", "int", 0, 0);
+	close(in);
+	close(out);
+	for(const char *threads: {"1", "4"}){
+		string command = string(program) + " -j " + threads + " " + input + " > " + output;
+		expect(system(command.c_str()) == 0, "batch.out exit status", "int", 0, 0);
+		ifstream results(output);
+		string line;
+		size_t i = 0;
+		while(getline(results, line)){
+			expect(i < expected.size() && line == expected[i], "batch.out output", "int", i, 0);
+			++i;
+		}
+		expect(i == expected.size(), "batch.out output length", "int", i, expected.size());
+	}
+	string empty = string(program) + " < /dev/null > " + output;
+	expect(system(empty.c_str()) == 0, "batch.out on empty input", "int", 0, 0);
+	unlink(input);
+	unlink(output);
+}
+
+/////////////////////////// VALUES ////////////////////////////////////////
+
+//0 - x takes a copy of x, hash included, and then changes its sign
+template <typename Number>
+void checkHashOfCopy(const char *type){
+	const string digits = "123456789012345678901234567890123456789012345678901234567890"; //more than 128 bits
+	Number zero, x, negative;
+	x.parse(digits.c_str(), digits.size());
+	negative.parse(("-" + digits).c_str(), digits.size() + 1);
+	x.hash();
+	Number difference = zero - x;
+	expect(difference == negative && difference.hash() == negative.hash(), "0 - x", type, 0, digits.size());
+	negative.hash();
+	Number positive = zero - negative;
+	expect(positive == x && positive.hash() == x.hash(), "0 - -x", type, 0, digits.size());
+	unordered_set<Number> values{negative};
+	expect(values.count(zero - x) == 1, "0 - x in an unordered_set", type, 0, digits.size());
+}
+
+//whether parse() turns 'line' down
+template <typename Number>
+bool parseRejects(Number &number, const char *line){
+	try{
+		number.parse(line, strlen(line));
+	}catch(invalid_argument&){
+		return true;
+	}
+	return false;
+}
+
+//text parse() turns down leaves the value as it was, sign included
+template <typename Number>
+void checkParseRejected(const char *type){
+	const char *const LINES[] = {"-1a", "+x", "-12345678901234567890123456789012345678901234567890x"};
+	for(const char *line: LINES){
+		Number zero, five(5);
+		expect(parseRejects(zero, line) && zero == Number() && zero.compare(Number()) == 0 &&
+			   parseRejects(five, line) && five == 5 && five.compare(Number(5)) == 0,
+			   "parse of a rejected line", type, strlen(line), 0);
+	}
+}
+
+//a MemoryBudget turns down what doesn't fit and gets back all it lent, in every build
+void checkBudget(){
+	const size_t DIGITS = 20000, LIMBS = (DIGITS + 8) / 9;
+	BigInt<int,Vector> a, b;
+	a.parse(string(DIGITS, '7').c_str(), DIGITS);
+	b.parse(string(DIGITS, '3').c_str(), DIGITS);
+	bool thrown = false;
+	{
+		MemoryBudget budget(1 << 12);
+		try{
+			BigInt<int,Vector> product = a * b;
+		}catch(MemoryBudgetExceeded&){
+			thrown = true;
+		}
+		expect(thrown && budget.used() == 0, "budget", "int", LIMBS, LIMBS);
+	}
+	{
+		MemoryBudget budget(size_t(1) << 24);
+		{
+			BigInt<int,Vector> product = a * b;
+			expect(product == a * b && budget.used() > 0, "budget", "int", LIMBS, LIMBS);
+		}
+		expect(budget.used() == 0, "budget", "int", LIMBS, LIMBS);
+	}
+}
+
+//whether making a 'digits' long Number throws MemoryBudgetExceeded
+template <typename Number>
+bool overBudget(size_t digits){
+	try{
+		Number number;
+		number.parse(string(digits, '9').c_str(), digits);
+	}catch(MemoryBudgetExceeded&){
+		return true;
+	}
+	return false;
+}
+
+//memory a budget wasn't charged for makes no room in it, wherever it comes from
+void checkBudgetCredits(){
+	const size_t DIGITS = 20000;
+	{ //a value made before the budget, freed while it is in scope
+		BigInt<int,Vector> before;
+		before.parse(string(DIGITS, '7').c_str(), DIGITS);
+		MemoryBudget budget(1000);
+		before = BigInt<int,Vector>();
+		expect(budget.used() == 0 && overBudget<BigInt<int,Vector>>(DIGITS), "freeing memory from outside a budget", "int", DIGITS, 0);
+	}
+	{ //nodes a ThreadList keeps for reuse
+		ThreadList<int> nodes;
+		for(size_t i = 0; i < DIGITS / 9; i++)
+			nodes.push_back(1);
+		nodes.clear();
+		{
+			MemoryBudget budget(1000);
+			expect(overBudget<BigInt<int,ThreadList>>(DIGITS), "reused ThreadList nodes", "int", DIGITS, 0);
+		}
+		MemoryBudget budget(size_t(1) << 24);
+		expect(!overBudget<BigInt<int,ThreadList>>(DIGITS) && budget.used() == 0, "reused ThreadList nodes", "int", DIGITS, 0);
+	}
+	int64_t used = -1;
+	thread fresh([&used]{ //a thread whose table of radix powers is still empty
+		MemoryBudget budget(size_t(1) << 24);
+		overBudget<BigInt<unsigned,Vector>>(50000);
+		used = budget.used();
+	});
+	fresh.join();
+	expect(used == 0, "radix powers", "unsigned", 50000, 0);
+}
+
+//a copy that runs out of budget halfway leaves the ChunkedList assigned to as it was
+void checkChunkedCopy(){
+	ChunkedList<int> source, target;
+	for(int i = 0; i < 10000; i++)
+		source.push_back(i);
+	for(int i = 0; i < 10; i++)
+		target.push_back(-i);
+	bool thrown = false;
+	{
+		MemoryBudget budget(sizeof(int) * source.size() / 2);
+		try{
+			target = source;
+		}catch(MemoryBudgetExceeded&){
+			thrown = true;
+		}
+		expect(thrown && budget.used() == 0, "ChunkedList copy", "int", source.size(), target.size());
+	}
+	int expected = 0;
+	size_t walked = 0;
+	for(int value: target)
+		expect(value == expected--, "ChunkedList copy", "int", source.size(), walked++);
+	expect(walked == 10 && target.size() == 10, "ChunkedList copy", "int", source.size(), target.size());
+	target = source;
+	expected = 0;
+	walked = 0;
+	for(int value: target)
+		expect(value == expected++, "ChunkedList copy", "int", source.size(), walked++);
+	expect(walked == source.size() && target.size() == source.size(), "ChunkedList copy", "int", source.size(), target.size());
+}
+
+const char *const LEVEL_NAMES[] = {"scalar", "AVX2", "AVX-512"};
+
+int main(int argc, char *argv[]){
+	ParallelThresholds &parallel = parallelThresholds(); //before the pool is made
+	parallel.threads = 4;
+	parallel.add = 64;
+	parallel.addBlock = 16;
+	parallel.mul = 24;
+	parallel.nttGrain = 8;
+	MulThresholds &mul = mulThresholds();
+	mul.karatsuba = 8;
+	mul.toom3 = 24;
+	mul.ntt = 96;
+	divThresholds().burnikelZiegler = 8;
+	RadixThresholds &radix = radixThresholds();
+	radix.fromDecimal = 2;
+	radix.toDecimal = 2;
+
+	checkType<char>("char");
+	checkType<short>("short");
+	checkType<int>("int");
+	checkType<long long>("long long");
+	checkType<unsigned char>("unsigned char");
+	checkType<unsigned short>("unsigned short");
+	checkType<unsigned>("unsigned");
+	checkType<unsigned long long>("unsigned long long");
+	printf("kernels (up to %s): %s\n", LEVEL_NAMES[simdDetect()], failures == 0? "ok": "FAILED");
+
+	size_t before = failures;
+	checkSerialization();
+	printf("serialization: %s\n", failures == before? "ok": "FAILED");
+
+	before = failures;
+	forEachNumber([](auto number, const char *type){ checkArithmetic<typename decltype(number)::type>(type); });
+	printf("arithmetic and comparisons: %s\n", failures == before? "ok": "FAILED");
+
+	before = failures;
+	forEachNumber([](auto number, const char *type){ checkNative<typename decltype(number)::type>(type); });
+	printf("built-in integers: %s\n", failures == before? "ok": "FAILED");
+
+	before = failures;
+	forEachNumber([](auto number, const char *type){
+		checkText<typename decltype(number)::type>(type);
+		checkMappedFile<typename decltype(number)::type>(type);
+	});
+	printf("text and MappedFile: %s\n", failures == before? "ok": "FAILED");
+
+	before = failures;
+	checkHashOfCopy<BigInt<int,Vector>>("int");
+	checkHashOfCopy<BigInt<unsigned,Vector>>("unsigned");
+	checkHashOfCopy<BigInt<char,List>>("char");
+	printf("hashes of copies: %s\n", failures == before? "ok": "FAILED");
+
+	before = failures;
+	checkParseRejected<BigInt<int,Vector>>("int");
+	checkParseRejected<BigInt<unsigned,Vector>>("unsigned");
+	checkParseRejected<BigInt<char,List>>("char");
+	printf("rejected text: %s\n", failures == before? "ok": "FAILED");
+
+	before = failures;
+	checkBudget();
+	checkBudgetCredits();
+	printf("memory budgets: %s\n", failures == before? "ok": "FAILED");
+
+	before = failures;
+	checkChunkedCopy();
+	printf("ChunkedList copies: %s\n", failures == before? "ok": "FAILED");
+
+	if(argc > 1){ //the path of batch.out
+		before = failures;
+		checkBatch(argv[1]);
+		printf("batch.out: %s\n", failures == before? "ok": "FAILED");
+	}
+
+	if(failures > 0)
+		fprintf(stderr, "%zu checks failed\n", failures);
+	return (failures == 0? EXIT_SUCCESS: EXIT_FAILURE);
+}
@@ -0,0 +1,312 @@
+#ifndef CHUNKEDLIST_H
+#define CHUNKEDLIST_H
+
+#include <iostream>
+#include <algorithm>
+#include "nosuchobject.h"
+#include "memory.h"
+
+using namespace std;
+
+/* An unrolled list: a doubly linked list of blocks, each holding up to BLOCK
+ * elements next to each other. Elements are only added and removed at the
+ * two ends, so every block except the first and the last one is full (a
+ * BigInt only grows at the back, which leaves at most one block partially
+ * used), and iterating mostly steps through an array. The sentinel is part
+ * of the list itself, so an empty list allocates nothing.
+ */
+
+//elements per block, so that a block holds about 512 bytes of them
+template <typename T>
+constexpr size_t chunkedListBlock() noexcept{
+	return (sizeof(T) < 512? 512 / sizeof(T): 1);
+}
+
+template <typename T, size_t BLOCK>
+class BasicChunkedList;
+
+template <typename T, size_t BLOCK>
+ostream& operator<<(ostream &, const BasicChunkedList<T,BLOCK>& );
+
+template <typename T, size_t BLOCK>
+class BasicChunkedList{
+  friend ostream& operator<< <>(ostream&, const BasicChunkedList<T,BLOCK>&);
+
+  private:
+	struct Link{ //the sentinel is a Link without any elements
+		Link *next;
+		Link *prev;
+		size_t first; //the elements of a block are at [first, last)
+		size_t last;
+	};
+	struct Block:Link{
+		T objects[BLOCK];
+	};
+
+  public:
+	class Iterator{
+		friend class BasicChunkedList;
+		Link *block;
+		size_t index;
+	  public:
+		Iterator():block{nullptr},index{0}{}
+		Iterator(Link *link, size_t position):block{link},index{position}{}
+		Iterator& operator--(){ //prefix--
+			if(index == block->first){
+				block = block->prev;
+				index = (block->last > block->first? block->last - 1: block->first);
+			}
+			else
+				--index;
+			return *this;
+		}
+		Iterator operator--(int){ //postfix--
+			Iterator old = *this;
+			--(*this);
+			return old;
+		}
+		Iterator& operator++(){ //prefix++
+			if(++index >= block->last){
+				block = block->next;
+				index = block->first;
+			}
+			return *this;
+		}
+		Iterator operator++(int){ //postfix++
+			Iterator old = *this;
+			++(*this);
+			return old;
+		}
+		T& operator*(){
+			return static_cast<Block*>(block)->objects[index];
+		}
+		bool operator==(const Iterator& other) const{
+			return block == other.block && index == other.index;
+		}
+		bool operator!=(const Iterator& other) const{
+			return !(*this == other);
+		}
+	}; //Iterator sub-class
+
+  private:
+	Link head;
+	size_t sz;
+	Link* linkBlock(Link *before, size_t position);
+	void unlinkBlock(Link *block) noexcept;
+	void takeBlocks(BasicChunkedList<T,BLOCK> &other) noexcept;
+
+  public:
+	BasicChunkedList();
+	BasicChunkedList(const BasicChunkedList<T,BLOCK> &other);
+	BasicChunkedList(BasicChunkedList<T,BLOCK> &&other) noexcept;
+	~BasicChunkedList();
+	void clear();
+	void push_back(const T& value = T{});
+	void push_front(const T& value = T{});
+	void pop_back();
+	void pop_front();
+	T &front() const;
+	T &back() const;
+	Iterator begin() const noexcept;
+	Iterator end() const noexcept;
+	Iterator prev(Iterator it) const;
+	bool empty() const noexcept;
+	size_t size() const noexcept;
+	const BasicChunkedList<T,BLOCK> &operator=(const BasicChunkedList<T,BLOCK> &other);
+	const BasicChunkedList<T,BLOCK> &operator=(BasicChunkedList<T,BLOCK> &&other) noexcept;
+	void printChunkedList() const noexcept;
+}; // BasicChunkedList class
+
+//one parameter, so that it matches BigInt's template <typename> typename C without C++17 rules
+template <typename T>
+using ChunkedList = BasicChunkedList<T, chunkedListBlock<T>()>;
+
+///////////////////////// FRIEND FUNCTIONS ///////////////////////////////
+
+template <typename T, size_t BLOCK>
+ostream& operator<<(ostream &out, const BasicChunkedList<T,BLOCK> &list){
+	for(auto current:list)
+		out << current;
+	return out;
+}
+
+///////////////////////// PRIVATE METHODS ////////////////////////////////
+
+//links a new, empty block before 'before', with its elements starting at 'position'
+template <typename T, size_t BLOCK>
+typename BasicChunkedList<T,BLOCK>::Link* BasicChunkedList<T,BLOCK>::linkBlock(Link *before, size_t position){
+	Link *block = memoryNewObject<Block>(MEMORY_CHUNKED_LIST);
+	block->first = block->last = position;
+	block->next = before;
+	block->prev = before->prev;
+	before->prev->next = block;
+	before->prev = block;
+	return block;
+}
+
+template <typename T, size_t BLOCK>
+void BasicChunkedList<T,BLOCK>::unlinkBlock(Link *block) noexcept{
+	block->prev->next = block->next;
+	block->next->prev = block->prev;
+	memoryDeleteObject(MEMORY_CHUNKED_LIST, static_cast<Block*>(block));
+}
+
+//moves the blocks of 'other' (which is left empty) behind the sentinel of this empty list
+template <typename T, size_t BLOCK>
+void BasicChunkedList<T,BLOCK>::takeBlocks(BasicChunkedList<T,BLOCK> &other) noexcept{
+	if(other.sz > 0){
+		head.next = other.head.next;
+		head.prev = other.head.prev;
+		head.next->prev = &head;
+		head.prev->next = &head;
+		sz = other.sz;
+		other.head.next = other.head.prev = &other.head;
+		other.sz = 0;
+	}
+}
+
+///////////////////////// PUBLIC METHODS ////////////////////////////////
+
+template <typename T, size_t BLOCK>
+BasicChunkedList<T,BLOCK>::BasicChunkedList():head{&head, &head, 0, 0},sz{0}{}
+
+template <typename T, size_t BLOCK>
+BasicChunkedList<T,BLOCK>::BasicChunkedList(const BasicChunkedList<T,BLOCK> &other):BasicChunkedList(){
+	*this = other;
+}
+
+//move constructor, 'other' is left empty
+template <typename T, size_t BLOCK>
+BasicChunkedList<T,BLOCK>::BasicChunkedList(BasicChunkedList<T,BLOCK> &&other) noexcept:BasicChunkedList(){
+	takeBlocks(other);
+}
+
+template <typename T, size_t BLOCK>
+BasicChunkedList<T,BLOCK>::~BasicChunkedList(){
+	clear();
+}
+
+template <typename T, size_t BLOCK>
+void BasicChunkedList<T,BLOCK>::clear(){
+	while(head.next != &head)
+		unlinkBlock(head.next);
+	sz = 0;
+}
+
+template <typename T, size_t BLOCK>
+void BasicChunkedList<T,BLOCK>::push_back(const T& value){
+	Link *tail = head.prev;
+	if(tail == &head || tail->last == BLOCK) //the last block is full
+		tail = linkBlock(&head, 0);
+	static_cast<Block*>(tail)->objects[tail->last++] = value;
+	sz++;
+}
+
+template <typename T, size_t BLOCK>
+void BasicChunkedList<T,BLOCK>::push_front(const T& value){
+	Link *front = head.next;
+	if(front == &head || front->first == 0) //the first block is full at its front
+		front = linkBlock(head.next, BLOCK);
+	static_cast<Block*>(front)->objects[--front->first] = value;
+	sz++;
+}
+
+template <typename T, size_t BLOCK>
+void BasicChunkedList<T,BLOCK>::pop_back(){
+	if(sz>0){
+		Link *tail = head.prev;
+		if(--tail->last == tail->first)
+			unlinkBlock(tail);
+		sz--;
+	}
+	else
+		throw NoSuchObject("ChunkedList::pop_back: error! tried popping an empty list");
+}
+
+template <typename T, size_t BLOCK>
+void BasicChunkedList<T,BLOCK>::pop_front(){
+	if(sz>0){
+		Link *front = head.next;
+		if(++front->first == front->last)
+			unlinkBlock(front);
+		sz--;
+	}
+	else
+		throw NoSuchObject("ChunkedList::pop_front: error! tried popping an empty list");
+}
+
+template <typename T, size_t BLOCK>
+T& BasicChunkedList<T,BLOCK>::front() const{
+	if(sz<=0)
+		throw NoSuchObject("ChunkedList::front: error! tried accessing an empty list");
+	return static_cast<Block*>(head.next)->objects[head.next->first];
+}
+
+template <typename T, size_t BLOCK>
+T& BasicChunkedList<T,BLOCK>::back() const{
+	if(sz<=0)
+		throw NoSuchObject("ChunkedList::back: error! tried accessing an empty list");
+	return static_cast<Block*>(head.prev)->objects[head.prev->last - 1];
+}
+
+template <typename T, size_t BLOCK>
+typename BasicChunkedList<T,BLOCK>::Iterator BasicChunkedList<T,BLOCK>::begin() const noexcept{
+	Iterator first(head.next, head.next->first);
+	return first;
+}
+
+template <typename T, size_t BLOCK>
+typename BasicChunkedList<T,BLOCK>::Iterator BasicChunkedList<T,BLOCK>::end() const noexcept{
+	Iterator last(const_cast<Link*>(&head), 0);
+	return last;
+}
+
+template <typename T, size_t BLOCK>
+typename BasicChunkedList<T,BLOCK>::Iterator BasicChunkedList<T,BLOCK>::prev(Iterator it) const{
+	return --it;
+}
+
+template <typename T, size_t BLOCK>
+bool BasicChunkedList<T,BLOCK>::empty() const noexcept{
+	return sz==0;
+}
+
+template <typename T, size_t BLOCK>
+size_t BasicChunkedList<T,BLOCK>::size() const noexcept{
+	return sz;
+}
+
+//copies block by block, keeping the layout of 'other'; if a block can't be allocated this list is left as it was
+template <typename T, size_t BLOCK>
+const BasicChunkedList<T,BLOCK>& BasicChunkedList<T,BLOCK>::operator=(const BasicChunkedList<T,BLOCK> &other){
+	if(&other != this){
+		BasicChunkedList<T,BLOCK> copy;
+		for(Link *block = other.head.next; block != &other.head; block = block->next){
+			Link *target = copy.linkBlock(&copy.head, block->first);
+			target->last = block->last;
+			const T *objects = static_cast<Block*>(block)->objects;
+			std::copy(objects + block->first, objects + block->last, static_cast<Block*>(target)->objects + block->first);
+			copy.sz += block->last - block->first;
+		}
+		clear();
+		takeBlocks(copy);
+	}
+	return *this;
+}
+
+template <typename T, size_t BLOCK>
+const BasicChunkedList<T,BLOCK>& BasicChunkedList<T,BLOCK>::operator=(BasicChunkedList<T,BLOCK> &&other) noexcept{
+	if(&other != this){
+		clear();
+		takeBlocks(other);
+	}
+	return *this;
+}
+
+template <typename T, size_t BLOCK>
+void BasicChunkedList<T,BLOCK>::printChunkedList() const noexcept{
+	for(auto current:*this)
+		cout << current << " ";
+}
+
+#endif
@@ -0,0 +1,177 @@
+#ifndef DIVIDE_H
+#define DIVIDE_H
+
+#include "limb.h"
+#include "multiply.h"
+#include "vector.h"
+#include <algorithm>
+
+/* Division of little-endian limb arrays. limbDivmod uses Knuth's algorithm D
+ * while the divisor (or the quotient) is shorter than the Burnikel-Ziegler
+ * threshold, and the recursive Burnikel-Ziegler division above it, which
+ * costs a small constant times a multiplication of the same size.
+ *
+ * The default can be changed when compiling (-DBIGINT_BZ_THRESHOLD=...) or at
+ * runtime through divThresholds().
+ */
+
+#ifndef BIGINT_BZ_THRESHOLD
+#define BIGINT_BZ_THRESHOLD 60
+#endif
+
+struct DivThresholds{
+	size_t burnikelZiegler; //smallest divisor (in limbs) divided recursively
+};
+
+inline DivThresholds& divThresholds() noexcept{
+	static DivThresholds thresholds = {BIGINT_BZ_THRESHOLD};
+	return thresholds;
+}
+
+/////////////////////////// SCHOOLBOOK ////////////////////////////////////////
+
+//Knuth's algorithm D; needs na >= nb and b[nb-1] != 0,
+//q holds na - nb + 1 limbs and r holds nb limbs
+template <typename T>
+void limbDivmodSchoolbook(T *q, T *r, const T *a, size_t na, const T *b, size_t nb){
+	typedef typename LimbTraits<T>::Wide Wide;
+	const Wide BASE = LimbTraits<T>::BASE;
+	if(nb == 1){
+		r[0] = limbDivSmall(q, a, na, b[0]);
+		return;
+	}
+	//scale both so that the top limb of the divisor is at least BASE/2
+	T scale = static_cast<T>(BASE / (Wide(b[nb-1]) + 1));
+	Vector<T> dividend(na + 1), divisor(nb);
+	T *u = dividend.begin(), *v = divisor.begin();
+	u[na] = limbMulSmall(u, a, na, scale);
+	limbMulSmall(v, b, nb, scale);
+
+	const Wide top = v[nb-1], next = v[nb-2];
+	for(size_t j = na - nb + 1; j-- > 0;){
+		Wide numerator = Wide(u[j + nb]) * BASE + Wide(u[j + nb - 1]);
+		Wide estimate = numerator / top, rest = numerator % top;
+		while(estimate >= BASE || estimate * next > rest * BASE + Wide(u[j + nb - 2])){
+			--estimate;
+			rest += top;
+			if(rest >= BASE)
+				break;
+		}
+		if(estimate >= BASE)
+			estimate = BASE - 1;
+		T borrow = limbSubMul(u + j, v, nb, static_cast<T>(estimate));
+		if(Wide(u[j + nb]) < Wide(borrow)){ //the estimate was one too large, add v back
+			--estimate;
+			T carry = limbAddN(u + j, u + j, v, nb);
+			u[j + nb] = static_cast<T>((Wide(u[j + nb]) + BASE - Wide(borrow) + Wide(carry)) % BASE);
+		}
+		else
+			u[j + nb] = static_cast<T>(Wide(u[j + nb]) - Wide(borrow));
+		q[j] = static_cast<T>(estimate);
+	}
+	limbDivSmall(r, u, nb, scale);
+}
+
+/////////////////////////// BURNIKEL-ZIEGLER //////////////////////////////////
+
+template <typename T>
+void bzDiv3n2n(T *q, T *r, const T *a, const T *b, size_t h);
+
+//q (n limbs) and r (n limbs) from a (2n limbs) / b (n limbs),
+//where a < b * BASE^n and the top limb of b is at least BASE/2
+template <typename T>
+void bzDiv2n1n(T *q, T *r, const T *a, const T *b, size_t n){
+	if(n % 2 == 1 || n < std::max(divThresholds().burnikelZiegler, size_t(2))){
+		Vector<T> quotient(n + 1);
+		limbDivmodSchoolbook(quotient.begin(), r, a, 2 * n, b, n);
+		std::copy(quotient.begin(), quotient.begin() + n, q); //the top limb is 0
+		return;
+	}
+	size_t h = n / 2;
+	Vector<T> middle(3 * h); //[A4 R1], R1 being the remainder of [A1 A2 A3] / B
+	std::copy(a, a + h, middle.begin());
+	bzDiv3n2n(q + h, middle.begin() + h, a + h, b, h);
+	bzDiv3n2n(q, r, middle.begin(), b, h);
+}
+
+//q (h limbs) and r (2h limbs) from a (3h limbs) / b (2h limbs),
+//where a < b * BASE^h and the top limb of b is at least BASE/2
+template <typename T>
+void bzDiv3n2n(T *q, T *r, const T *a, const T *b, size_t h){
+	const T *a1 = a + 2 * h, *b1 = b + h;
+	Vector<T> partial(2 * h + 1, T(0)); //[R1 A3], R1 can be one limb longer than h
+	T *x = partial.begin();
+	std::copy(a, a + h, x);
+	if(limbCompare(a1, h, b1, h) < 0)
+		bzDiv2n1n(q, x + h, a + h, b1, h);
+	else{ //the estimate is BASE^h - 1, so R1 = [A1 A2] - B1 * BASE^h + B1
+		std::fill(q, q + h, static_cast<T>(LimbTraits<T>::BASE - 1));
+		Vector<T> upper(2 * h);
+		T *t = upper.begin();
+		std::copy(a + h, a + 3 * h, t);
+		limbSub(t + h, t + h, h, b1, h);
+		limbAdd(t, t, 2 * h, b1, h);
+		std::copy(t, t + h + 1, x + h);
+	}
+
+	//subtract D = Q * B2; while the result would be negative, the estimate is too large
+	Vector<T> product(2 * h);
+	T *d = product.begin();
+	limbMul(d, q, h, b, h);
+	while(limbCompare(x, 2 * h + 1, d, 2 * h) < 0){
+		x[2 * h] = static_cast<T>(x[2 * h] + limbAdd(x, x, 2 * h, b, 2 * h));
+		limbSubBorrow(q, q, h, T(1));
+	}
+	limbSub(x, x, 2 * h + 1, d, 2 * h);
+	std::copy(x, x + 2 * h, r);
+}
+
+//pads the divisor to a block size n = j * 2^k, and divides the dividend
+//block by block with bzDiv2n1n
+template <typename T>
+void limbDivmodBurnikelZiegler(T *q, T *r, const T *a, size_t na, const T *b, size_t nb){
+	typedef typename LimbTraits<T>::Wide Wide;
+	const size_t limit = std::max(divThresholds().burnikelZiegler, size_t(2));
+	size_t m = 1;
+	while(m * limit <= nb)
+		m <<= 1;
+	const size_t n = (nb + m - 1) / m * m;
+	const size_t shift = n - nb;
+
+	//scale and shift both so that the divisor fills n limbs and its top limb is at least BASE/2
+	T scale = static_cast<T>(LimbTraits<T>::BASE / (Wide(b[nb-1]) + 1));
+	Vector<T> divisor(n, T(0));
+	limbMulSmall(divisor.begin() + shift, b, nb, scale);
+	const size_t length = na + 1 + shift;
+	const size_t blocks = std::max(size_t(2), (length + n) / n); //leaves the top limb 0
+	Vector<T> dividend(blocks * n, T(0));
+	dividend[na + shift] = limbMulSmall(dividend.begin() + shift, a, na, scale);
+
+	Vector<T> quotient((blocks - 1) * n), window(2 * n), remainder(n);
+	T *z = window.begin();
+	std::copy(dividend.begin() + (blocks - 2) * n, dividend.end(), z);
+	for(size_t i = blocks - 1; i-- > 0;){
+		bzDiv2n1n(quotient.begin() + i * n, remainder.begin(), z, divisor.begin(), n);
+		if(i > 0){
+			std::copy(dividend.begin() + (i - 1) * n, dividend.begin() + i * n, z);
+			std::copy(remainder.begin(), remainder.end(), z + n);
+		}
+	}
+	std::copy(quotient.begin(), quotient.begin() + (na - nb + 1), q);
+	limbDivSmall(r, remainder.begin() + shift, nb, scale);
+}
+
+/////////////////////////// DISPATCH //////////////////////////////////////////
+
+//q = a / b and r = a % b; needs na >= nb and b[nb-1] != 0,
+//q holds na - nb + 1 limbs and r holds nb limbs
+template <typename T>
+void limbDivmod(T *q, T *r, const T *a, size_t na, const T *b, size_t nb){
+	const size_t limit = divThresholds().burnikelZiegler;
+	if(nb < limit || na - nb < limit)
+		limbDivmodSchoolbook(q, r, a, na, b, nb);
+	else
+		limbDivmodBurnikelZiegler(q, r, a, na, b, nb);
+}
+
+#endif
@@ -0,0 +1,54 @@
+#ifndef HASH_H
+#define HASH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+using namespace std;
+
+/* A fast hash of the limbs of a BigInt, in the style of wyhash: limbs
+ * narrower than 64 bits are packed into 64 bit words, and every word is
+ * folded into the state with one 64x64 -> 128 bit multiplication, whose
+ * halves are xor'd together. It is not meant to resist inputs chosen to
+ * collide, only to spread ordinary values well (see BigInt::hash, which
+ * caches it, and the std::hash<BigInt> of bigint.h).
+ */
+
+const uint64_t HASH_P0 = 0xa0761d6478bd642full;
+const uint64_t HASH_P1 = 0xe7037ed1a0b428dbull;
+const uint64_t HASH_P2 = 0x8ebc6af09c88c6e3ull;
+
+//the 128 bit product of a and b, its two halves xor'd together
+inline uint64_t hashMix(uint64_t a, uint64_t b) noexcept{
+	unsigned __int128 product = static_cast<unsigned __int128>(a) * b;
+	return static_cast<uint64_t>(product) ^ static_cast<uint64_t>(product >> 64);
+}
+
+//hashes the n limbs from 'limb' on (least significant first), starting from 'seed'
+template <typename T, typename Iterator>
+uint64_t hashLimbs(Iterator limb, size_t n, uint64_t seed) noexcept{
+	typedef typename make_unsigned<T>::type Unsigned;
+	constexpr size_t PER_WORD = (sizeof(T) < 8? 8 / sizeof(T): 1);
+	uint64_t state = seed ^ HASH_P0;
+	size_t i = 0;
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+	if constexpr(is_pointer<Iterator>::value){ //whole words are loaded as they are, which packs them the same way
+		for(; i + PER_WORD <= n; i += PER_WORD, limb += PER_WORD){
+			uint64_t word;
+			memcpy(&word, limb, sizeof(word));
+			state = hashMix(word ^ HASH_P1, state ^ HASH_P2);
+		}
+	}
+#endif
+	for(; i < n; i += PER_WORD){
+		uint64_t word = 0;
+		for(size_t k = 0; k < PER_WORD && i + k < n; k++, ++limb)
+			word |= uint64_t(static_cast<Unsigned>(*limb)) << (k * 8 * sizeof(T));
+		state = hashMix(word ^ HASH_P1, state ^ HASH_P2);
+	}
+	return hashMix(state ^ HASH_P1, uint64_t(n) ^ HASH_P0);
+}
+
+#endif
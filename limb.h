@@ -0,0 +1,247 @@
+#ifndef LIMB_H
+#define LIMB_H
+
+#include <cstddef>
+#include <algorithm>
+
+/* LimbTraits<T> describes how a single element ("limb") of a BigInt's
+ * container is interpreted. Signed types store a base-10^DIGITS limb, so
+ * printing and parsing stay a straight regrouping of decimal digits.
+ * Unsigned types store a full base-2^n machine word, and need a radix
+ * conversion when printed or parsed.
+ *
+ *   BASE         - radix of one limb
+ *   DIGITS       - decimal digits per limb (0 for binary limbs)
+ *   CHUNK        - largest power of 10 that is <= BASE, used for conversions
+ *   CHUNK_DIGITS - log10(CHUNK)
+ *   Wide         - unsigned type that holds (BASE-1)*(BASE-1) + 2*(BASE-1)
+ *   NTT_PIECE    - radix a limb is split into for NTT multiplication
+ *   NTT_PIECES   - NTT pieces per limb, BASE == NTT_PIECE^NTT_PIECES
+ */
+template <typename T>
+struct LimbTraits; //left undefined for bool and floating point types
+
+//10^exponent, for exponent <= 19
+inline unsigned long long limbPow10(unsigned exponent) noexcept{
+	unsigned long long power = 1;
+	while(exponent-- > 0)
+		power *= 10;
+	return power;
+}
+
+template <typename W, unsigned long long B, unsigned D, unsigned long long P, unsigned PN>
+struct DecimalLimb{
+	typedef W Wide;
+	static constexpr bool BINARY = false;
+	static constexpr W BASE = B;
+	static constexpr unsigned DIGITS = D;
+	static constexpr unsigned long long CHUNK = B;
+	static constexpr unsigned CHUNK_DIGITS = D;
+	static constexpr unsigned long long NTT_PIECE = P;
+	static constexpr unsigned NTT_PIECES = PN;
+};
+
+template <typename W, unsigned BITS, unsigned long long C, unsigned CD, unsigned PN>
+struct BinaryLimb{
+	typedef W Wide;
+	static constexpr bool BINARY = true;
+	static constexpr W BASE = W(1) << BITS;
+	static constexpr unsigned DIGITS = 0;
+	static constexpr unsigned long long CHUNK = C;
+	static constexpr unsigned CHUNK_DIGITS = CD;
+	static constexpr unsigned long long NTT_PIECE = 1ULL << (BITS / PN);
+	static constexpr unsigned NTT_PIECES = PN;
+};
+
+template <size_t BYTES> struct DecimalLimbOfSize;
+template <> struct DecimalLimbOfSize<1>:DecimalLimb<unsigned, 100ULL, 2, 100, 1>{};
+template <> struct DecimalLimbOfSize<2>:DecimalLimb<unsigned, 10000ULL, 4, 10000, 1>{};
+template <> struct DecimalLimbOfSize<4>:DecimalLimb<unsigned long long, 1000000000ULL, 9, 1000000000ULL, 1>{};
+template <> struct DecimalLimbOfSize<8>:DecimalLimb<unsigned __int128, 1000000000000000000ULL, 18, 1000000000ULL, 2>{};
+
+template <size_t BYTES> struct BinaryLimbOfSize;
+template <> struct BinaryLimbOfSize<1>:BinaryLimb<unsigned, 8, 100ULL, 2, 1>{};
+template <> struct BinaryLimbOfSize<2>:BinaryLimb<unsigned, 16, 10000ULL, 4, 1>{};
+template <> struct BinaryLimbOfSize<4>:BinaryLimb<unsigned long long, 32, 1000000000ULL, 9, 1>{};
+template <> struct BinaryLimbOfSize<8>:BinaryLimb<unsigned __int128, 64, 10000000000000000000ULL, 19, 2>{};
+
+template <> struct LimbTraits<char>:DecimalLimbOfSize<sizeof(char)>{};
+template <> struct LimbTraits<signed char>:DecimalLimbOfSize<sizeof(signed char)>{};
+template <> struct LimbTraits<short>:DecimalLimbOfSize<sizeof(short)>{};
+template <> struct LimbTraits<int>:DecimalLimbOfSize<sizeof(int)>{};
+template <> struct LimbTraits<long>:DecimalLimbOfSize<sizeof(long)>{};
+template <> struct LimbTraits<long long>:DecimalLimbOfSize<sizeof(long long)>{};
+
+template <> struct LimbTraits<unsigned char>:BinaryLimbOfSize<sizeof(unsigned char)>{};
+template <> struct LimbTraits<unsigned short>:BinaryLimbOfSize<sizeof(unsigned short)>{};
+template <> struct LimbTraits<unsigned int>:BinaryLimbOfSize<sizeof(unsigned int)>{};
+template <> struct LimbTraits<unsigned long>:BinaryLimbOfSize<sizeof(unsigned long)>{};
+template <> struct LimbTraits<unsigned long long>:BinaryLimbOfSize<sizeof(unsigned long long)>{};
+
+//the most limbs whose value is always below 2^128, so that they can be worked on as an unsigned __int128
+template <typename T>
+constexpr size_t limbNativeLimbs() noexcept{
+	typedef unsigned __int128 Native;
+	const Native top = Native(LimbTraits<T>::BASE) - 1; //the largest limb
+	Native largest = 0; //BASE^n - 1, the largest value of n limbs
+	size_t n = 0;
+	while(largest <= (Native(~Native(0)) - top) / Native(LimbTraits<T>::BASE)){
+		largest = largest * Native(LimbTraits<T>::BASE) + top;
+		++n;
+	}
+	return n;
+}
+
+//////////////////////////// LIMB KERNELS /////////////////////////////////
+/* The kernels below work on little-endian limb arrays (least significant
+ * limb first), with sizes counted in limbs. An output may alias an input
+ * as long as both start at the same limb.
+ */
+
+//size of 'a' once the leading 0 limbs are dropped
+template <typename T>
+size_t limbNormalize(const T *a, size_t n) noexcept{
+	while(n > 0 && a[n-1] == 0)
+		--n;
+	return n;
+}
+
+//returns -1, 0 or 1 as a is less than, equal to or greater than b
+template <typename T>
+int limbCompare(const T *a, size_t na, const T *b, size_t nb) noexcept{
+	na = limbNormalize(a, na);
+	nb = limbNormalize(b, nb);
+	if(na != nb)
+		return (na > nb? 1: -1);
+	while(na-- > 0){
+		if(a[na] != b[na])
+			return (a[na] > b[na]? 1: -1);
+	}
+	return 0;
+}
+
+//r = a + b + carry over n limbs, returns the carry out of the top limb
+template <typename T>
+T limbAddN(T *r, const T *a, const T *b, size_t n, T carry = 0) noexcept{
+	typedef typename LimbTraits<T>::Wide Wide;
+	for(size_t i = 0; i < n; i++){
+		Wide sum = Wide(a[i]) + Wide(b[i]) + Wide(carry);
+		carry = (sum >= LimbTraits<T>::BASE);
+		r[i] = static_cast<T>(carry? sum - LimbTraits<T>::BASE: sum);
+	}
+	return carry;
+}
+
+//r = a - b - borrow over n limbs, returns the borrow out of the top limb
+template <typename T>
+T limbSubN(T *r, const T *a, const T *b, size_t n, T borrow = 0) noexcept{
+	typedef typename LimbTraits<T>::Wide Wide;
+	for(size_t i = 0; i < n; i++){
+		Wide subtrahend = Wide(b[i]) + Wide(borrow);
+		borrow = (Wide(a[i]) < subtrahend);
+		r[i] = static_cast<T>((borrow? Wide(a[i]) + LimbTraits<T>::BASE: Wide(a[i])) - subtrahend);
+	}
+	return borrow;
+}
+
+//r = a + carry over n limbs, returns the carry out of the top limb
+template <typename T>
+T limbAddCarry(T *r, const T *a, size_t n, T carry) noexcept{
+	typedef typename LimbTraits<T>::Wide Wide;
+	size_t i = 0;
+	for(; i < n && carry; i++){
+		Wide sum = Wide(a[i]) + Wide(carry);
+		carry = (sum >= LimbTraits<T>::BASE);
+		r[i] = static_cast<T>(carry? sum - LimbTraits<T>::BASE: sum);
+	}
+	if(r != a)
+		std::copy(a + i, a + n, r + i);
+	return carry;
+}
+
+//r = a - borrow over n limbs, returns the borrow out of the top limb
+template <typename T>
+T limbSubBorrow(T *r, const T *a, size_t n, T borrow) noexcept{
+	size_t i = 0;
+	for(; i < n && borrow; i++){
+		borrow = (a[i] == 0);
+		r[i] = static_cast<T>(borrow? LimbTraits<T>::BASE - 1: a[i] - 1);
+	}
+	if(r != a)
+		std::copy(a + i, a + n, r + i);
+	return borrow;
+}
+
+//r = a + b where na >= nb, r holds na limbs, returns the carry out
+template <typename T>
+T limbAdd(T *r, const T *a, size_t na, const T *b, size_t nb) noexcept{
+	T carry = limbAddN(r, a, b, nb);
+	return limbAddCarry(r + nb, a + nb, na - nb, carry);
+}
+
+//r = a - b where na >= nb, r holds na limbs, returns the borrow out
+template <typename T>
+T limbSub(T *r, const T *a, size_t na, const T *b, size_t nb) noexcept{
+	T borrow = limbSubN(r, a, b, nb);
+	return limbSubBorrow(r + nb, a + nb, na - nb, borrow);
+}
+
+//r = a * m for a single limb m, returns the carry limb
+template <typename T>
+T limbMulSmall(T *r, const T *a, size_t n, T m) noexcept{
+	typedef typename LimbTraits<T>::Wide Wide;
+	Wide carry = 0;
+	for(size_t i = 0; i < n; i++){
+		Wide current = Wide(a[i]) * Wide(m) + carry;
+		r[i] = static_cast<T>(current % LimbTraits<T>::BASE);
+		carry = current / LimbTraits<T>::BASE;
+	}
+	return static_cast<T>(carry);
+}
+
+//r += a * m for a single limb m, returns the carry limb
+template <typename T>
+T limbAddMul(T *r, const T *a, size_t n, T m) noexcept{
+	typedef typename LimbTraits<T>::Wide Wide;
+	Wide carry = 0;
+	for(size_t i = 0; i < n; i++){
+		Wide current = Wide(a[i]) * Wide(m) + Wide(r[i]) + carry;
+		r[i] = static_cast<T>(current % LimbTraits<T>::BASE);
+		carry = current / LimbTraits<T>::BASE;
+	}
+	return static_cast<T>(carry);
+}
+
+//r -= a * m for a single limb m, returns the limb still to be subtracted above r
+template <typename T>
+T limbSubMul(T *r, const T *a, size_t n, T m) noexcept{
+	typedef typename LimbTraits<T>::Wide Wide;
+	Wide carry = 0;
+	for(size_t i = 0; i < n; i++){
+		Wide product = Wide(a[i]) * Wide(m) + carry;
+		Wide low = product % LimbTraits<T>::BASE;
+		carry = product / LimbTraits<T>::BASE;
+		if(Wide(r[i]) >= low)
+			r[i] = static_cast<T>(Wide(r[i]) - low);
+		else{
+			r[i] = static_cast<T>(Wide(r[i]) + LimbTraits<T>::BASE - low);
+			++carry;
+		}
+	}
+	return static_cast<T>(carry);
+}
+
+//q = a / d for a single nonzero limb d, returns the remainder
+template <typename T>
+T limbDivSmall(T *q, const T *a, size_t n, T d) noexcept{
+	typedef typename LimbTraits<T>::Wide Wide;
+	Wide remainder = 0;
+	while(n-- > 0){
+		Wide current = remainder * LimbTraits<T>::BASE + Wide(a[n]);
+		q[n] = static_cast<T>(current / Wide(d));
+		remainder = current % Wide(d);
+	}
+	return static_cast<T>(remainder);
+}
+
+#endif
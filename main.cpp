@@ -4,7 +4,7 @@ using namespace std;
 
 int main(int argc, char *argv[]){	
 	try{
-		ifstream iFile(argv[1]);
+		MappedFile iFile(argv[1]);
 		
 		if(!iFile.is_open()){
 			cerr << "Could not open " << argv[1] << endl;
@@ -38,7 +38,6 @@ int main(int argc, char *argv[]){
 		cout << three << endl;
 
 
-		iFile.get(traverse); //to get rid of \n character at end of line
 		iFile.close();
 
 	}catch(logic_error &e){
@@ -46,7 +45,7 @@ int main(int argc, char *argv[]){
 	}
 	cout << endl << "# # # # # # # # # # # # # # # # # # # # # # # # # #" << endl << endl;
 	try{
-		ifstream iFile(argv[1]);
+		MappedFile iFile(argv[1]);
 		
 		if(!iFile.is_open()){
 			cerr << "Could not open " << argv[1] << endl;
@@ -81,7 +80,6 @@ int main(int argc, char *argv[]){
 		cout << "___________________________" << endl;
 		cout << three << endl;
 
-		iFile.get(traverse); //to get rid of \n character at end of line
 		}
 	}catch(logic_error &e){
 			cout << e.what() << endl;
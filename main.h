@@ -2,6 +2,7 @@
 #define MAIN_H
 
 #include "bigint.h"
+#include "mapped.h"
 #include <string>
 #include <iomanip>
 
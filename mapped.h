@@ -0,0 +1,181 @@
+#ifndef MAPPED_H
+#define MAPPED_H
+
+#include "bigint.h"
+#include "nosuchobject.h"
+#include <cctype>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/* Reads BigInts, and the operators between them, straight out of a memory
+ * mapped file. Like operator>> on an ifstream, every BigInt is one line,
+ * but the line is parsed where it lies in the mapped pages (no string, no
+ * stream buffer), so files of hundreds of MB are read with a single pass
+ * over their digits. By default the kernel is told the file is read front
+ * to back (madvise), so it reads ahead and drops the pages behind.
+ */
+class MappedFile{
+  public:
+	MappedFile() noexcept;
+	explicit MappedFile(const char *path, bool sequential = true);
+	MappedFile(MappedFile &&other) noexcept;
+	MappedFile(const MappedFile&) = delete;
+	~MappedFile();
+	MappedFile& operator=(MappedFile &&other) noexcept;
+	MappedFile& operator=(const MappedFile&) = delete;
+	bool open(const char *path, bool sequential = true);
+	void close() noexcept;
+	bool is_open() const noexcept;
+	bool eof() const noexcept;
+	size_t size() const noexcept;
+	const char* begin() const noexcept;
+	const char* end() const noexcept;
+	bool getLine(const char *&line, size_t &lineLength) noexcept;
+	template <typename T, template <typename> typename C>
+	MappedFile& operator>>(BigInt<T,C> &bigint);
+	MappedFile& operator>>(char &symbol);
+
+  private:
+	const char *data; //the mapped file, nullptr when it is empty
+	size_t length;
+	const char *cursor; //start of the next unread line
+	bool opened;
+};
+
+///////////////////////// PUBLIC METHODS ////////////////////////////////
+
+inline MappedFile::MappedFile() noexcept:data{nullptr},length{0},cursor{nullptr},opened{false}{}
+
+//check is_open() afterwards, as with an ifstream
+inline MappedFile::MappedFile(const char *path, bool sequential):MappedFile(){
+	open(path, sequential);
+}
+
+//move constructor, 'other' is left closed
+inline MappedFile::MappedFile(MappedFile &&other) noexcept
+	:data{other.data},length{other.length},cursor{other.cursor},opened{other.opened}{
+	other.data = other.cursor = nullptr;
+	other.length = 0;
+	other.opened = false;
+}
+
+inline MappedFile::~MappedFile(){
+	close();
+}
+
+inline MappedFile& MappedFile::operator=(MappedFile &&other) noexcept{
+	if(&other != this){
+		close();
+		data = other.data;
+		length = other.length;
+		cursor = other.cursor;
+		opened = other.opened;
+		other.data = other.cursor = nullptr;
+		other.length = 0;
+		other.opened = false;
+	}
+	return *this;
+}
+
+//maps the whole file at 'path' for reading, returns whether it worked
+inline bool MappedFile::open(const char *path, bool sequential){
+	close();
+	int descriptor = ::open(path, O_RDONLY);
+	if(descriptor < 0)
+		return false;
+	struct stat status;
+	if(fstat(descriptor, &status) != 0){
+		::close(descriptor);
+		return false;
+	}
+	length = static_cast<size_t>(status.st_size);
+	if(length > 0){ //an empty file can't be mapped, and has nothing to read anyway
+		void *mapping = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, descriptor, 0);
+		if(mapping == MAP_FAILED){
+			::close(descriptor);
+			length = 0;
+			return false;
+		}
+		if(sequential)
+			madvise(mapping, length, MADV_SEQUENTIAL);
+		data = static_cast<const char*>(mapping);
+	}
+	::close(descriptor); //the mapping stays valid without it
+	cursor = data;
+	opened = true;
+	return true;
+}
+
+inline void MappedFile::close() noexcept{
+	if(data != nullptr)
+		munmap(const_cast<char*>(data), length);
+	data = cursor = nullptr;
+	length = 0;
+	opened = false;
+}
+
+inline bool MappedFile::is_open() const noexcept{
+	return opened;
+}
+
+//whether every line has been read
+inline bool MappedFile::eof() const noexcept{
+	return cursor == data + length;
+}
+
+inline size_t MappedFile::size() const noexcept{
+	return length;
+}
+
+//the mapped bytes, for reading binary data such as serialized BigInts (see BigInt::deserialize)
+inline const char* MappedFile::begin() const noexcept{
+	return data;
+}
+
+inline const char* MappedFile::end() const noexcept{
+	return data + length;
+}
+
+//points 'line' at the next line, 'length' excludes its '\n'; returns false when there is none left
+inline bool MappedFile::getLine(const char *&line, size_t &lineLength) noexcept{
+	if(eof())
+		return false;
+	const char *end = data + length;
+	const char *newline = static_cast<const char*>(memchr(cursor, '\n', end - cursor));
+	line = cursor;
+	lineLength = (newline != nullptr? newline: end) - cursor;
+	cursor = (newline != nullptr? newline + 1: end);
+	return true;
+}
+
+//reads the next line as a BigInt, see BigInt::parse
+template <typename T, template <typename> typename C>
+MappedFile& MappedFile::operator>>(BigInt<T,C> &bigint){
+	BIGINT_STAT_SCOPE(STAT_READ, 0);
+	const char *line;
+	size_t lineLength;
+	if(!getLine(line, lineLength))
+		throw NoSuchObject("MappedFile::operator>>: error! tried reading past the end of the file");
+	bigint.parse(line, lineLength);
+	BIGINT_STAT_LIMBS(bigint.getCount());
+	return *this;
+}
+
+//reads the next character that isn't whitespace (such as an operator), and skips the rest of its line
+inline MappedFile& MappedFile::operator>>(char &symbol){
+	const char *end = data + length;
+	while(cursor != end && isspace(static_cast<unsigned char>(*cursor)))
+		++cursor;
+	if(cursor == end)
+		throw NoSuchObject("MappedFile::operator>>: error! tried reading past the end of the file");
+	symbol = *cursor;
+	const char *line;
+	size_t lineLength;
+	getLine(line, lineLength);
+	return *this;
+}
+
+#endif
@@ -0,0 +1,349 @@
+#ifndef MEMORY_H
+#define MEMORY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <atomic>
+#include <initializer_list>
+#include <iostream>
+#include <fstream>
+#include <cstdlib>
+#include <cstring>
+
+using namespace std;
+
+/* Allocation hooks of the containers. Vector, SmallVector, ChunkedList and
+ * the node allocators of List (see arena.h) get their memory from
+ * memoryNew/memoryNewArray/memoryNewObject and give it back through the
+ * matching memoryDelete functions, saying which kind of memory it is and how
+ * many bytes.
+ *
+ * A MemoryBudget limits the bytes the calling thread holds while it is in
+ * scope, counting the tasks the thread hands to a ThreadPool meanwhile: an
+ * allocation that would go past the limit throws MemoryBudgetExceeded (a
+ * bad_alloc) before anything is allocated, so the caller can give up on one
+ * input instead of being killed for running out of memory. Budgets nest,
+ * and an allocation counts against all of them. Memory given back counts
+ * against whichever budget is in scope then, but a budget never counts
+ * less than 0 bytes: memory it wasn't charged for (allocated before it, or
+ * outside of it by another thread) can't make room in it. With no budget
+ * in scope, the hooks only test one thread_local pointer on top of new and
+ * delete. Memory kept for reuse, like the free lists of ThreadNodes, is
+ * only charged while it is handed out (memoryBudgetCharge()).
+ *
+ * Built with -DBIGINT_MEMORY, every kind also counts its live bytes, the
+ * peak of those, and its allocations and releases (memoryOf(),
+ * writeMemoryJson(); the JSON also goes to the file named by
+ * BIGINT_MEMORY_FILE at exit, '-' for stderr). Those counters are shared by
+ * all threads, which costs about a quarter of the throughput of batch.cpp,
+ * so they are left out otherwise (BIGINT_STATS keeps counters of its own
+ * per thread, see MemoryThread).
+ */
+
+enum MemoryKind{
+	MEMORY_VECTOR,
+	MEMORY_SMALL_VECTOR,
+	MEMORY_HEAP_NODES,
+	MEMORY_ARENA_NODES,
+	MEMORY_THREAD_NODES, //the nodes on free lists included
+	MEMORY_CHUNKED_LIST,
+	MEMORY_KINDS
+};
+
+const char *const MEMORY_NAMES[MEMORY_KINDS] = {"Vector", "SmallVector", "HeapNodes", "ArenaNodes",
+												"ThreadNodes", "ChunkedList"};
+
+#if defined(BIGINT_MEMORY) || defined(BIGINT_STATS)
+#define BIGINT_TRACK_MEMORY
+#endif
+
+class MemoryBudgetExceeded:public bad_alloc{
+  public:
+	const char* what() const noexcept override{
+		return "MemoryBudget: error! an allocation would go past the memory budget";
+	}
+};
+
+//limits the bytes held by the calling thread (and its ThreadPool tasks) during its lifetime
+class MemoryBudget{
+  public:
+	explicit MemoryBudget(size_t limit) noexcept;
+	MemoryBudget(const MemoryBudget&) = delete;
+	MemoryBudget& operator=(const MemoryBudget&) = delete;
+	~MemoryBudget();
+	size_t limit() const noexcept;
+	int64_t used() const noexcept;
+	static MemoryBudget*& current() noexcept;
+	bool charge(size_t bytes) noexcept;
+	void credit(size_t bytes) noexcept;
+
+  private:
+	size_t bytes; //the limit
+	atomic<int64_t> usage; //allocated less given back while in scope, never below 0
+	MemoryBudget *outer; //the budget that was in scope before this one
+	void lower(size_t bytes) noexcept;
+};
+
+//puts the budget of another thread in scope for a while, see ThreadPool
+class MemoryBudgetScope{
+  public:
+	explicit MemoryBudgetScope(MemoryBudget *budget) noexcept;
+	MemoryBudgetScope(const MemoryBudgetScope&) = delete;
+	MemoryBudgetScope& operator=(const MemoryBudgetScope&) = delete;
+	~MemoryBudgetScope();
+
+  private:
+	MemoryBudget *saved;
+};
+
+///////////////////////// BUDGETS ////////////////////////////////////
+
+inline MemoryBudget::MemoryBudget(size_t limit) noexcept:bytes{limit},usage{0},outer{current()}{
+	current() = this;
+}
+
+inline MemoryBudget::~MemoryBudget(){
+	current() = outer;
+}
+
+inline size_t MemoryBudget::limit() const noexcept{
+	return bytes;
+}
+
+inline int64_t MemoryBudget::used() const noexcept{
+	return usage.load(memory_order_relaxed);
+}
+
+//the innermost budget in scope on the calling thread, nullptr if there is none
+inline MemoryBudget*& MemoryBudget::current() noexcept{
+	static thread_local MemoryBudget *budget = nullptr;
+	return budget;
+}
+
+//counts 'bytes' against this budget and the ones around it; returns false (counting nothing) if one of them would go over
+inline bool MemoryBudget::charge(size_t bytes) noexcept{
+	int64_t after = usage.fetch_add(bytes, memory_order_relaxed) + int64_t(bytes);
+	if(uint64_t(after) > this->bytes || (outer != nullptr && !outer->charge(bytes))){
+		lower(bytes);
+		return false;
+	}
+	return true;
+}
+
+//gives 'bytes' back to this budget and the ones around it, none of them going below 0
+inline void MemoryBudget::credit(size_t bytes) noexcept{
+	lower(bytes);
+	if(outer != nullptr)
+		outer->credit(bytes);
+}
+
+inline void MemoryBudget::lower(size_t bytes) noexcept{
+	int64_t held = usage.load(memory_order_relaxed);
+	while(!usage.compare_exchange_weak(held, held > int64_t(bytes)? held - int64_t(bytes): 0, memory_order_relaxed)){}
+}
+
+//counts 'bytes' against the budgets in scope alone, throwing MemoryBudgetExceeded if they don't fit
+inline void memoryBudgetCharge(size_t bytes){
+	MemoryBudget *budget = MemoryBudget::current();
+	if(budget != nullptr && !budget->charge(bytes))
+		throw MemoryBudgetExceeded();
+}
+
+inline void memoryBudgetCredit(size_t bytes) noexcept{
+	MemoryBudget *budget = MemoryBudget::current();
+	if(budget != nullptr)
+		budget->credit(bytes);
+}
+
+inline MemoryBudgetScope::MemoryBudgetScope(MemoryBudget *budget) noexcept:saved{MemoryBudget::current()}{
+	MemoryBudget::current() = budget;
+}
+
+inline MemoryBudgetScope::~MemoryBudgetScope(){
+	MemoryBudget::current() = saved;
+}
+
+///////////////////////// COUNTERS ////////////////////////////////////
+
+//raises 'peak' to 'live' if that is higher
+inline void memoryRaise(atomic<int64_t> &peak, int64_t live) noexcept{
+	int64_t seen = peak.load(memory_order_relaxed);
+	while(live > seen && !peak.compare_exchange_weak(seen, live, memory_order_relaxed)){}
+}
+
+#ifdef BIGINT_TRACK_MEMORY
+
+//what the calling thread allocated so far, for the counters of stats.h
+struct MemoryThread{
+	uint64_t allocations;
+	uint64_t bytes; //all the bytes allocated, never decreases
+	int64_t live; //allocated less given back by this thread
+	int64_t peak; //the highest 'live' since a StatScope last lowered it
+};
+
+inline MemoryThread& memoryThread() noexcept{
+	static thread_local MemoryThread counters = {0, 0, 0, 0};
+	return counters;
+}
+
+#endif
+
+#ifdef BIGINT_MEMORY
+
+struct MemoryStats{
+	atomic<int64_t> live;
+	atomic<int64_t> peak;
+	atomic<uint64_t> allocations;
+	atomic<uint64_t> releases;
+};
+
+//the counters of one kind of memory (or MEMORY_KINDS for all of them) at one point in time
+struct MemorySnapshot{
+	int64_t live;
+	int64_t peak;
+	uint64_t allocations;
+	uint64_t releases;
+};
+
+void writeMemoryJson(ostream &out);
+
+//writes the JSON to BIGINT_MEMORY_FILE, if it is set
+inline void dumpMemoryAtExit(){
+	const char *path = getenv("BIGINT_MEMORY_FILE");
+	if(path == nullptr)
+		return;
+	if(strcmp(path, "-") == 0){
+		writeMemoryJson(cerr);
+		return;
+	}
+	ofstream out(path);
+	if(out.is_open())
+		writeMemoryJson(out);
+}
+
+//one entry per kind, and the total last; the first call arranges for the dump at exit
+inline MemoryStats* memoryTable() noexcept{
+	static MemoryStats table[MEMORY_KINDS + 1]; //zero initialized, like any static
+	static bool registered = (atexit(dumpMemoryAtExit) == 0);
+	(void)registered;
+	return table;
+}
+
+inline MemorySnapshot memoryOf(MemoryKind kind) noexcept{
+	const MemoryStats &stats = memoryTable()[kind];
+	return {stats.live.load(memory_order_relaxed), stats.peak.load(memory_order_relaxed),
+			stats.allocations.load(memory_order_relaxed), stats.releases.load(memory_order_relaxed)};
+}
+
+//one object per kind of memory, and "total" for all of them
+inline void writeMemoryJson(ostream &out){
+	out << "{\n";
+	for(size_t kind = 0; kind <= MEMORY_KINDS; kind++){
+		MemorySnapshot stats = memoryOf(static_cast<MemoryKind>(kind));
+		out << "  \"" << (kind < MEMORY_KINDS? MEMORY_NAMES[kind]: "total") << "\": {\"live_bytes\": " << stats.live
+			<< ", \"peak_bytes\": " << stats.peak << ", \"allocations\": " << stats.allocations
+			<< ", \"releases\": " << stats.releases << "}" << (kind < MEMORY_KINDS? ",": "") << "\n";
+	}
+	out << "}\n";
+}
+
+#endif
+
+///////////////////////// HOOKS ////////////////////////////////////
+
+//counts 'bytes' of 'kind' as allocated, throwing MemoryBudgetExceeded if they don't fit the budget
+inline void memoryCharge(MemoryKind kind, size_t bytes){
+	memoryBudgetCharge(bytes);
+#ifdef BIGINT_MEMORY
+	MemoryStats *table = memoryTable();
+	for(MemoryStats *stats: {&table[kind], &table[MEMORY_KINDS]}){
+		stats->allocations.fetch_add(1, memory_order_relaxed);
+		memoryRaise(stats->peak, stats->live.fetch_add(bytes, memory_order_relaxed) + int64_t(bytes));
+	}
+#endif
+#ifdef BIGINT_TRACK_MEMORY
+	MemoryThread &thread = memoryThread();
+	++thread.allocations;
+	thread.bytes += bytes;
+	thread.live += bytes;
+	if(thread.live > thread.peak)
+		thread.peak = thread.live;
+#endif
+	(void)kind;
+	(void)bytes;
+}
+
+//counts 'bytes' of 'kind' as given back
+inline void memoryCredit(MemoryKind kind, size_t bytes) noexcept{
+	memoryBudgetCredit(bytes);
+#ifdef BIGINT_MEMORY
+	MemoryStats *table = memoryTable();
+	for(MemoryStats *stats: {&table[kind], &table[MEMORY_KINDS]}){
+		stats->releases.fetch_add(1, memory_order_relaxed);
+		stats->live.fetch_sub(bytes, memory_order_relaxed);
+	}
+#endif
+#ifdef BIGINT_TRACK_MEMORY
+	memoryThread().live -= bytes;
+#endif
+	(void)kind;
+	(void)bytes;
+}
+
+inline void* memoryNew(MemoryKind kind, size_t bytes){
+	memoryCharge(kind, bytes);
+	try{
+		return ::operator new(bytes);
+	}catch(...){
+		memoryCredit(kind, bytes);
+		throw;
+	}
+}
+
+inline void memoryDelete(MemoryKind kind, void *memory, size_t bytes) noexcept{
+	if(memory == nullptr)
+		return;
+	::operator delete(memory);
+	memoryCredit(kind, bytes);
+}
+
+template <typename T>
+T* memoryNewArray(MemoryKind kind, size_t count){
+	memoryCharge(kind, count * sizeof(T));
+	try{
+		return new T[count];
+	}catch(...){
+		memoryCredit(kind, count * sizeof(T));
+		throw;
+	}
+}
+
+template <typename T>
+void memoryDeleteArray(MemoryKind kind, T *array, size_t count) noexcept{
+	if(array == nullptr)
+		return;
+	delete[] array;
+	memoryCredit(kind, count * sizeof(T));
+}
+
+template <typename T>
+T* memoryNewObject(MemoryKind kind){
+	memoryCharge(kind, sizeof(T));
+	try{
+		return new T;
+	}catch(...){
+		memoryCredit(kind, sizeof(T));
+		throw;
+	}
+}
+
+template <typename T>
+void memoryDeleteObject(MemoryKind kind, T *object) noexcept{
+	if(object == nullptr)
+		return;
+	delete object;
+	memoryCredit(kind, sizeof(T));
+}
+
+#endif
@@ -0,0 +1,462 @@
+#ifndef MULTIPLY_H
+#define MULTIPLY_H
+
+#include "limb.h"
+#include "vector.h"
+#include "parallel.h"
+#include <algorithm>
+
+/* Multiplication of little-endian limb arrays. limbMul picks an algorithm
+ * from the size of the smaller operand:
+ *
+ *   size <  karatsuba  - schoolbook, O(n^2)
+ *   size <  toom3      - Karatsuba, O(n^1.58)
+ *   size <  ntt        - Toom-3, O(n^1.46)
+ *   size >= ntt        - number theoretic transform, O(n log n)
+ *
+ * The defaults can be changed when compiling (-DBIGINT_KARATSUBA_THRESHOLD=...)
+ * or at runtime through mulThresholds(). Large products use several
+ * threads, see parallel.h.
+ */
+
+#ifndef BIGINT_KARATSUBA_THRESHOLD
+#define BIGINT_KARATSUBA_THRESHOLD 32
+#endif
+
+#ifndef BIGINT_TOOM3_THRESHOLD
+#define BIGINT_TOOM3_THRESHOLD 160
+#endif
+
+#ifndef BIGINT_NTT_THRESHOLD
+#define BIGINT_NTT_THRESHOLD 1500
+#endif
+
+struct MulThresholds{
+	size_t karatsuba; //smallest operand (in limbs) multiplied with Karatsuba
+	size_t toom3; //smallest operand multiplied with Toom-3
+	size_t ntt; //smallest operand multiplied with the NTT
+};
+
+inline MulThresholds& mulThresholds() noexcept{
+	static MulThresholds thresholds = {BIGINT_KARATSUBA_THRESHOLD,
+									   BIGINT_TOOM3_THRESHOLD,
+									   BIGINT_NTT_THRESHOLD};
+	return thresholds;
+}
+
+template <typename T>
+void limbMul(T *r, const T *a, size_t na, const T *b, size_t nb);
+
+/////////////////////////// SCHOOLBOOK ////////////////////////////////////////
+
+template <typename T>
+void limbMulSchoolbook(T *r, const T *a, size_t na, const T *b, size_t nb){
+	std::fill(r, r + na + nb, T(0));
+	for(size_t i = 0; i < nb; i++)
+		r[i + na] = limbAddMul(r + i, a, na, b[i]);
+}
+
+//when a is at least twice as long as b, multiply b by each nb-limb block of a
+template <typename T>
+void limbMulUnbalanced(T *r, const T *a, size_t na, const T *b, size_t nb){
+	std::fill(r, r + na + nb, T(0));
+	Vector<T> partial(2 * nb);
+	for(size_t offset = 0; offset < na; offset += nb){
+		size_t length = std::min(nb, na - offset);
+		limbMul(partial.begin(), a + offset, length, b, nb);
+		limbAdd(r + offset, r + offset, na + nb - offset, partial.begin(), length + nb);
+	}
+}
+
+/////////////////////////// KARATSUBA /////////////////////////////////////////
+
+//requires nb <= na < 2*nb, so that both high halves are nonempty
+template <typename T>
+void limbMulKaratsuba(T *r, const T *a, size_t na, const T *b, size_t nb){
+	size_t m = na / 2;
+	size_t na1 = na - m, nb1 = nb - m;
+	size_t nsa = na1 + 1, nsb = std::max(m, nb1) + 1;
+	Vector<T> sumA(nsa), sumB(nsb);
+	sumA[na1] = limbAdd(sumA.begin(), a + m, na1, a, m);
+	if(nb1 >= m)
+		sumB[nsb-1] = limbAdd(sumB.begin(), b + m, nb1, b, m);
+	else
+		sumB[nsb-1] = limbAdd(sumB.begin(), b, m, b + m, nb1);
+
+	//z0 = a0*b0 goes in r[0, 2m), z2 = a1*b1 in r[2m, na+nb), and (a0+a1)(b0+b1) in 'middle'
+	Vector<T> middle(nsa + nsb, T(0));
+	T *z1 = middle.begin();
+	auto low = [&]{ limbMul(r, a, m, b, m); };
+	auto high = [&]{ limbMul(r + 2 * m, a + m, na1, b + m, nb1); };
+	auto sums = [&]{ limbMul(z1, sumA.begin(), limbNormalize(sumA.begin(), nsa),
+								 sumB.begin(), limbNormalize(sumB.begin(), nsb)); };
+	if(parallelMul(nb))
+		parallelInvoke(low, high, sums);
+	else{
+		low();
+		high();
+		sums();
+	}
+
+	//z1 = (a0+a1)(b0+b1) - z0 - z2, added in at limb m
+	limbSub(z1, z1, nsa + nsb, r, 2 * m);
+	limbSub(z1, z1, nsa + nsb, r + 2 * m, na1 + nb1);
+	limbAdd(r + m, r + m, na + nb - m, z1, limbNormalize(z1, nsa + nsb));
+}
+
+/////////////////////////// TOOM-3 ////////////////////////////////////////////
+
+//a signed value with a fixed number of limbs, used during Toom-3 interpolation
+template <typename T>
+struct ToomTerm{
+	Vector<T> limbs;
+	size_t size;
+	bool negative;
+	explicit ToomTerm(size_t capacity):limbs(capacity, T(0)),size{0},negative{false}{}
+	T* data() const noexcept { return limbs.begin(); }
+};
+
+//term += (negative? -1: 1) * b
+template <typename T>
+void toomAdd(ToomTerm<T> &term, const T *b, size_t nb, bool negative){
+	nb = limbNormalize(b, nb);
+	if(nb == 0)
+		return;
+	if(term.size == 0 || term.negative == negative){
+		size_t n = std::max(term.size, nb);
+		T carry = (n == nb? limbAdd(term.data(), b, nb, term.data(), n):
+							limbAdd(term.data(), term.data(), n, b, nb));
+		term.data()[n] = carry;
+		term.size = n + 1;
+		term.negative = negative;
+	}
+	else if(limbCompare(term.data(), term.size, b, nb) >= 0)
+		limbSub(term.data(), term.data(), term.size, b, nb);
+	else{
+		limbSub(term.data(), b, nb, term.data(), term.size);
+		term.size = nb;
+		term.negative = negative;
+	}
+	term.size = limbNormalize(term.data(), term.size);
+	if(term.size == 0)
+		term.negative = false;
+}
+
+template <typename T>
+void toomAdd(ToomTerm<T> &term, const ToomTerm<T> &other){
+	toomAdd(term, other.data(), other.size, other.negative);
+}
+
+template <typename T>
+void toomSub(ToomTerm<T> &term, const ToomTerm<T> &other){
+	toomAdd(term, other.data(), other.size, !other.negative);
+}
+
+template <typename T>
+void toomAssign(ToomTerm<T> &term, const ToomTerm<T> &other){
+	std::copy(other.data(), other.data() + other.size, term.data());
+	std::fill(term.data() + other.size, term.data() + term.limbs.size(), T(0));
+	term.size = other.size;
+	term.negative = other.negative;
+}
+
+template <typename T>
+void toomMulSmall(ToomTerm<T> &term, T m){
+	T carry = limbMulSmall(term.data(), term.data(), term.size, m);
+	if(carry)
+		term.data()[term.size++] = carry;
+}
+
+//the division has to be exact
+template <typename T>
+void toomDivSmall(ToomTerm<T> &term, T d){
+	limbDivSmall(term.data(), term.data(), term.size, d);
+	term.size = limbNormalize(term.data(), term.size);
+}
+
+template <typename T>
+void toomMul(ToomTerm<T> &product, const ToomTerm<T> &x, const ToomTerm<T> &y){
+	if(x.size == 0 || y.size == 0)
+		return;
+	limbMul(product.data(), x.data(), x.size, y.data(), y.size);
+	product.size = limbNormalize(product.data(), x.size + y.size);
+	product.negative = (x.negative != y.negative);
+}
+
+//p(0), p(1), p(-1), p(-2) for p(x) = p2*x^2 + p1*x + p0, a split in k-limb pieces
+template <typename T>
+void toomEvaluate(const T *a, size_t na, size_t k, ToomTerm<T> &atOne,
+				  ToomTerm<T> &atMinusOne, ToomTerm<T> &atMinusTwo){
+	size_t n0 = std::min(na, k);
+	size_t n1 = (na > k? std::min(na - k, k): 0);
+	size_t n2 = (na > 2 * k? na - 2 * k: 0);
+	const T *p0 = a, *p1 = a + k, *p2 = a + 2 * k;
+	toomAdd(atOne, p0, n0, false);
+	toomAdd(atOne, p2, n2, false); //p0 + p2
+	toomAssign(atMinusOne, atOne);
+	toomAdd(atMinusOne, p1, n1, true); //p0 - p1 + p2
+	toomAdd(atOne, p1, n1, false); //p0 + p1 + p2
+	toomAssign(atMinusTwo, atMinusOne);
+	toomAdd(atMinusTwo, p2, n2, false);
+	toomMulSmall(atMinusTwo, T(2));
+	toomAdd(atMinusTwo, p0, n0, true); //2*(p(-1) + p2) - p0
+}
+
+//requires nb <= na < 2*nb; evaluates at 0, 1, -1, -2 and infinity
+template <typename T>
+void limbMulToom3(T *r, const T *a, size_t na, const T *b, size_t nb){
+	size_t k = (na + 2) / 3;
+	size_t capacity = 2 * k + 4;
+	ToomTerm<T> a1(capacity), am1(capacity), am2(capacity);
+	ToomTerm<T> b1(capacity), bm1(capacity), bm2(capacity);
+	toomEvaluate(a, na, k, a1, am1, am2);
+	toomEvaluate(b, nb, k, b1, bm1, bm2);
+
+	//r(0) and r(inf) go straight into their final place in r
+	std::fill(r, r + na + nb, T(0));
+	size_t nb0 = std::min(nb, k), nbInf = (nb > 2 * k? nb - 2 * k: 0);
+	ToomTerm<T> r1(capacity), rm1(capacity), rm2(capacity), r3(capacity);
+	auto atZero = [&]{ limbMul(r, a, k, b, nb0); };
+	auto atInfinity = [&]{
+		if(nbInf > 0)
+			limbMul(r + 4 * k, a + 2 * k, na - 2 * k, b + 2 * k, nbInf);
+	};
+	auto atOne = [&]{ toomMul(r1, a1, b1); };
+	auto atMinusOne = [&]{ toomMul(rm1, am1, bm1); };
+	auto atMinusTwo = [&]{ toomMul(rm2, am2, bm2); };
+	if(parallelMul(nb))
+		parallelInvoke(atZero, atInfinity, atOne, atMinusOne, atMinusTwo);
+	else{
+		atZero();
+		atInfinity();
+		atOne();
+		atMinusOne();
+		atMinusTwo();
+	}
+	size_t n0 = limbNormalize(r, 2 * k);
+	size_t nInf = (na + nb > 4 * k? limbNormalize(r + 4 * k, na + nb - 4 * k): 0);
+
+	//interpolation, following Bodrato's sequence
+	toomAssign(r3, rm2);
+	toomSub(r3, r1);
+	toomDivSmall(r3, T(3)); //r3 = (r(-2) - r(1)) / 3
+	toomSub(r1, rm1);
+	toomDivSmall(r1, T(2)); //r1 = (r(1) - r(-1)) / 2
+	toomAdd(rm1, r, n0, true); //r2 = r(-1) - r(0)
+	ToomTerm<T> &r2 = rm1;
+	toomAssign(rm2, r2);
+	toomSub(rm2, r3);
+	toomDivSmall(rm2, T(2));
+	toomAdd(rm2, r + 4 * k, nInf, false);
+	toomAdd(rm2, r + 4 * k, nInf, false); //r3 = (r2 - r3) / 2 + 2*r(inf)
+	ToomTerm<T> &coefficient3 = rm2;
+	toomAdd(r2, r1);
+	toomAdd(r2, r + 4 * k, nInf, true); //r2 = r2 + r1 - r(inf)
+	toomSub(r1, coefficient3); //r1 = r1 - r3
+
+	//the remaining coefficients are nonnegative, add them in at their offsets
+	limbAdd(r + k, r + k, na + nb - k, r1.data(), r1.size);
+	limbAdd(r + 2 * k, r + 2 * k, na + nb - 2 * k, r2.data(), r2.size);
+	limbAdd(r + 3 * k, r + 3 * k, na + nb - 3 * k, coefficient3.data(), coefficient3.size);
+}
+
+/////////////////////////// NTT ///////////////////////////////////////////////
+
+/* Each limb is split into NTT_PIECES pieces below NTT_PIECE (at most 2^32),
+ * the pieces are convolved modulo three primes, and the coefficients are
+ * recombined with Garner's CRT. A coefficient is at most 2^25 * 2^64 = 2^89,
+ * below the product of the primes (~2^90.5), as long as the transform has
+ * at most 2^26 points.
+ */
+const unsigned NTT_PRIME_0 = 469762049u, NTT_ROOT_0 = 3u; //7 * 2^26 + 1
+const unsigned NTT_PRIME_1 = 1811939329u, NTT_ROOT_1 = 13u; //27 * 2^26 + 1
+const unsigned NTT_PRIME_2 = 2013265921u, NTT_ROOT_2 = 31u; //15 * 2^27 + 1
+const size_t NTT_MAX_SIZE = size_t(1) << 26;
+
+inline unsigned nttPow(unsigned long long base, unsigned long long exponent, unsigned modulus) noexcept{
+	unsigned long long result = 1;
+	base %= modulus;
+	while(exponent > 0){
+		if(exponent & 1)
+			result = result * base % modulus;
+		base = base * base % modulus;
+		exponent >>= 1;
+	}
+	return static_cast<unsigned>(result);
+}
+
+//butterflies [first, last) of the stage that combines blocks of 'length' points, counted
+//block after block; w and wq hold the stage's twiddles and their Shoup quotients
+template <unsigned MODULUS>
+void nttButterflies(unsigned *a, size_t length, const unsigned *w, const unsigned *wq,
+					size_t first, size_t last) noexcept{
+	size_t half = length / 2;
+	while(first < last){
+		size_t j = first % half, end = std::min(half, j + (last - first));
+		unsigned *low = a + first / half * length, *high = low + half;
+		first += end - j;
+		for(; j < end; j++){
+			unsigned u = low[j];
+			unsigned long long estimate = ((unsigned long long)high[j] * wq[j]) >> 32;
+			unsigned v = static_cast<unsigned>((unsigned long long)high[j] * w[j] - estimate * MODULUS);
+			//min() of the two candidates keeps the reductions branch free
+			v = std::min(v, v - MODULUS);
+			low[j] = std::min(u + v, u + v - MODULUS);
+			high[j] = std::min(u - v, u - v + MODULUS);
+		}
+	}
+}
+
+//in-place iterative transform, n has to be a power of 2
+template <unsigned MODULUS, unsigned ROOT>
+void nttTransform(unsigned *a, size_t n, bool inverse){
+	for(size_t i = 1, j = 0; i < n; i++){ //bit-reversal permutation
+		size_t bit = n >> 1;
+		for(; j & bit; bit >>= 1)
+			j ^= bit;
+		j ^= bit;
+		if(i < j)
+			std::swap(a[i], a[j]);
+	}
+	//twiddles are kept with Shoup's precomputed quotient floor(w * 2^32 / MODULUS),
+	//so each butterfly needs only 32x32 -> 64 bit products
+	Vector<unsigned> twiddles(std::max(n / 2, size_t(1))), quotients(std::max(n / 2, size_t(1)));
+	unsigned *w = twiddles.begin(), *wq = quotients.begin();
+	size_t grain = (parallelThreads() > 1? std::max(parallelThresholds().nttGrain, size_t(1)): n);
+	for(size_t length = 2; length <= n; length <<= 1){
+		unsigned step = nttPow(ROOT, (MODULUS - 1) / length, MODULUS);
+		if(inverse)
+			step = nttPow(step, MODULUS - 2, MODULUS);
+		size_t half = length / 2;
+		w[0] = 1;
+		for(size_t j = 1; j < half; j++)
+			w[j] = static_cast<unsigned>((unsigned long long)w[j-1] * step % MODULUS);
+		for(size_t j = 0; j < half; j++)
+			wq[j] = static_cast<unsigned>(((unsigned long long)w[j] << 32) / MODULUS);
+		if(grain < n / 2) //the stage's n/2 butterflies are independent of each other
+			parallelPool().parallelFor(0, n / 2, grain, [=](size_t first, size_t last){
+				nttButterflies<MODULUS>(a, length, w, wq, first, last);
+			});
+		else
+			nttButterflies<MODULUS>(a, length, w, wq, 0, n / 2);
+	}
+	if(inverse){
+		unsigned long long scale = nttPow(n, MODULUS - 2, MODULUS);
+		for(size_t i = 0; i < n; i++)
+			a[i] = static_cast<unsigned>(a[i] * scale % MODULUS);
+	}
+}
+
+template <typename T, unsigned MODULUS>
+void nttSplit(const T *a, size_t na, unsigned *pieces){
+	typedef LimbTraits<T> Traits;
+	for(size_t i = 0; i < na; i++){
+		typename Traits::Wide limb = a[i];
+		for(unsigned j = 0; j < Traits::NTT_PIECES; j++){
+			*(pieces++) = static_cast<unsigned>(static_cast<unsigned long long>(limb % Traits::NTT_PIECE) % MODULUS);
+			limb /= Traits::NTT_PIECE;
+		}
+	}
+}
+
+//the cyclic convolution of a and b modulo MODULUS ends up in left
+template <typename T, unsigned MODULUS, unsigned ROOT>
+void nttConvolve(const T *a, size_t na, const T *b, size_t nb, unsigned *left, unsigned *right, size_t n){
+	std::fill(left, left + n, 0u);
+	std::fill(right, right + n, 0u);
+	nttSplit<T, MODULUS>(a, na, left);
+	nttSplit<T, MODULUS>(b, nb, right);
+	nttTransform<MODULUS, ROOT>(left, n, false);
+	nttTransform<MODULUS, ROOT>(right, n, false);
+	for(size_t i = 0; i < n; i++)
+		left[i] = static_cast<unsigned>((unsigned long long)left[i] * right[i] % MODULUS);
+	nttTransform<MODULUS, ROOT>(left, n, true);
+}
+
+template <typename T>
+size_t nttSize(size_t na, size_t nb) noexcept{
+	size_t pieces = (na + nb) * LimbTraits<T>::NTT_PIECES;
+	size_t n = 1;
+	while(n < pieces)
+		n <<= 1;
+	return n;
+}
+
+template <typename T>
+bool nttFits(size_t na, size_t nb) noexcept{
+	return (na + nb) * LimbTraits<T>::NTT_PIECES <= NTT_MAX_SIZE;
+}
+
+template <typename T>
+void limbMulNtt(T *r, const T *a, size_t na, const T *b, size_t nb){
+	typedef LimbTraits<T> Traits;
+	typedef typename Traits::Wide Wide;
+	const size_t n = nttSize<T>(na, nb);
+	Vector<unsigned> first(n), second(n), third(n), scratch(n);
+	auto convolve0 = [&](unsigned *right){ nttConvolve<T, NTT_PRIME_0, NTT_ROOT_0>(a, na, b, nb, first.begin(), right, n); };
+	auto convolve1 = [&](unsigned *right){ nttConvolve<T, NTT_PRIME_1, NTT_ROOT_1>(a, na, b, nb, second.begin(), right, n); };
+	auto convolve2 = [&](unsigned *right){ nttConvolve<T, NTT_PRIME_2, NTT_ROOT_2>(a, na, b, nb, third.begin(), right, n); };
+	if(parallelMul(nb)){ //the three primes at the same time, each with scratch space of its own
+		Vector<unsigned> scratch1(n), scratch2(n);
+		parallelInvoke([&]{ convolve0(scratch.begin()); },
+					   [&]{ convolve1(scratch1.begin()); },
+					   [&]{ convolve2(scratch2.begin()); });
+	}
+	else{
+		convolve0(scratch.begin());
+		convolve1(scratch.begin());
+		convolve2(scratch.begin());
+	}
+
+	//Garner: x = x0 + x1*p0 + x2*p0*p1, then carry in base NTT_PIECE
+	const unsigned long long p0 = NTT_PRIME_0, p1 = NTT_PRIME_1, p2 = NTT_PRIME_2;
+	const unsigned long long inverse01 = nttPow(p0, p1 - 2, p1);
+	const unsigned long long inverse02 = nttPow(p0, p2 - 2, p2);
+	const unsigned long long inverse12 = nttPow(p1, p2 - 2, p2);
+	const unsigned *r0 = first.begin(), *r1 = second.begin(), *r2 = third.begin();
+	unsigned __int128 carry = 0;
+	for(size_t i = 0; i < na + nb; i++){
+		Wide limb = 0, scale = 1;
+		for(unsigned j = 0; j < Traits::NTT_PIECES; j++){
+			unsigned long long x0 = *(r0++);
+			unsigned long long x1 = (*(r1++) + p1 - x0 % p1) % p1 * inverse01 % p1;
+			unsigned long long x2 = (*(r2++) + p2 - x0 % p2) % p2 * inverse02 % p2;
+			x2 = (x2 + p2 - x1 % p2) % p2 * inverse12 % p2;
+			unsigned __int128 total = x0 + (unsigned __int128)x1 * p0
+									  + (unsigned __int128)x2 * p0 * p1 + carry;
+			limb += scale * static_cast<Wide>(total % Traits::NTT_PIECE);
+			carry = total / Traits::NTT_PIECE;
+			scale *= Traits::NTT_PIECE;
+		}
+		r[i] = static_cast<T>(limb);
+	}
+}
+
+/////////////////////////// DISPATCH //////////////////////////////////////////
+
+//r = a * b, r holds na + nb limbs
+template <typename T>
+void limbMul(T *r, const T *a, size_t na, const T *b, size_t nb){
+	if(na < nb){
+		std::swap(a, b);
+		std::swap(na, nb);
+	}
+	if(nb == 0){
+		std::fill(r, r + na, T(0));
+		return;
+	}
+	const MulThresholds &limits = mulThresholds();
+	const size_t karatsuba = std::max(limits.karatsuba, size_t(4)); //smaller recursion would not shrink
+	if(nb < karatsuba)
+		limbMulSchoolbook(r, a, na, b, nb);
+	else if(nb >= limits.ntt && nttFits<T>(na, nb))
+		limbMulNtt(r, a, na, b, nb);
+	else if(na >= 2 * nb)
+		limbMulUnbalanced(r, a, na, b, nb);
+	else if(nb < std::max(limits.toom3, karatsuba))
+		limbMulKaratsuba(r, a, na, b, nb);
+	else
+		limbMulToom3(r, a, na, b, nb);
+}
+
+#endif
@@ -0,0 +1,165 @@
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include "limb.h"
+#include "simd.h"
+#include "vector.h"
+#include "threadpool.h"
+#include <cstddef>
+#include <algorithm>
+#include <thread>
+
+/* Limb kernels that split very large operands between the threads of one
+ * shared ThreadPool, made the first time it is needed.
+ *
+ * Addition is done in blocks of ParallelThresholds::addBlock limbs, each
+ * added on its own with a carry in of 0. A block then either generates a
+ * carry out of its own, or would propagate a carry in (all its limbs are
+ * BASE-1), or stops it. A pass over the blocks works out the carry into
+ * each of them from that, the same way a carry lookahead adder does, and
+ * the blocks that get one add it in, again in parallel; it rarely goes
+ * past their first limb. Subtraction does the same with borrows, which
+ * pass through blocks of 0's.
+ *
+ * Multiplication (see multiply.h) runs the independent products of a
+ * Karatsuba or Toom-3 step as tasks once the operands reach
+ * ParallelThresholds::mul limbs, so the top levels of the recursion spread
+ * over the threads and the levels below stay sequential. The NTT convolves
+ * modulo its three primes at the same time, and splits each stage of
+ * butterflies into tasks of ParallelThresholds::nttGrain butterflies.
+ *
+ * The defaults can be changed when compiling (-DBIGINT_PARALLEL_ADD_THRESHOLD=...)
+ * or at runtime through parallelThresholds(); 'threads' is read when the
+ * pool is made, and with a single thread everything runs on the caller.
+ */
+
+#ifndef BIGINT_THREADS
+#define BIGINT_THREADS 0 //one per core
+#endif
+
+#ifndef BIGINT_PARALLEL_ADD_THRESHOLD
+#define BIGINT_PARALLEL_ADD_THRESHOLD 262144
+#endif
+
+#ifndef BIGINT_PARALLEL_ADD_BLOCK
+#define BIGINT_PARALLEL_ADD_BLOCK 65536
+#endif
+
+#ifndef BIGINT_PARALLEL_MUL_THRESHOLD
+#define BIGINT_PARALLEL_MUL_THRESHOLD 1000
+#endif
+
+#ifndef BIGINT_PARALLEL_NTT_GRAIN
+#define BIGINT_PARALLEL_NTT_GRAIN 16384
+#endif
+
+struct ParallelThresholds{
+	size_t threads; //threads of the pool, 0 for one per core
+	size_t add; //smallest addition or subtraction (in limbs) done in parallel
+	size_t addBlock; //limbs added by one task
+	size_t mul; //smallest operand (in limbs) whose products are split between threads
+	size_t nttGrain; //butterflies of an NTT stage done by one task
+};
+
+inline ParallelThresholds& parallelThresholds() noexcept{
+	static ParallelThresholds thresholds = {BIGINT_THREADS,
+											BIGINT_PARALLEL_ADD_THRESHOLD,
+											BIGINT_PARALLEL_ADD_BLOCK,
+											BIGINT_PARALLEL_MUL_THRESHOLD,
+											BIGINT_PARALLEL_NTT_GRAIN};
+	return thresholds;
+}
+
+//the threads the pool has, or would have once it is made
+inline size_t parallelThreads() noexcept{
+	size_t threads = parallelThresholds().threads;
+	if(threads == 0)
+		threads = thread::hardware_concurrency();
+	return (threads > 0? threads: 1);
+}
+
+inline ThreadPool& parallelPool(){
+	static ThreadPool pool(parallelThreads());
+	return pool;
+}
+
+//whether a product whose smaller operand has nb limbs is split between threads
+inline bool parallelMul(size_t nb) noexcept{
+	return nb >= parallelThresholds().mul && parallelThreads() > 1;
+}
+
+//runs every one of 'tasks' on the pool, and returns once they have all run
+template <typename... F>
+void parallelInvoke(F&&... tasks){
+	ThreadPool &pool = parallelPool();
+	TaskGroup group;
+	(pool.submit(group, function<void()>(std::forward<F>(tasks))), ...);
+	pool.wait(group);
+}
+
+//r = a + b + carry over n limbs like simdAddN, split into blocks once n is large enough
+template <typename T>
+T parallelAddN(T *r, const T *a, const T *b, size_t n, T carry = 0){
+	const ParallelThresholds &thresholds = parallelThresholds();
+	if(n < thresholds.add || parallelThreads() < 2)
+		return simdAddN(r, a, b, n, carry);
+	size_t block = max(thresholds.addBlock, size_t(1));
+	size_t blocks = (n + block - 1) / block;
+	Vector<unsigned char> generate(blocks), propagate(blocks);
+	parallelPool().parallelFor(0, blocks, 1, [&](size_t first, size_t last){
+		for(size_t k = first; k < last; k++){
+			size_t from = k * block, length = min(block, n - from);
+			T *limbs = r + from;
+			generate[k] = static_cast<unsigned char>(simdAddN(limbs, a + from, b + from, length));
+			propagate[k] = (find_if(limbs, limbs + length, [](T limb){ return limb != T(LimbTraits<T>::BASE - 1); })
+							== limbs + length);
+		}
+	});
+	Vector<unsigned char> carryIn(blocks);
+	for(size_t k = 0; k < blocks; k++){
+		carryIn[k] = static_cast<unsigned char>(carry);
+		carry = (generate[k] || (carry && propagate[k]));
+	}
+	parallelPool().parallelFor(0, blocks, 1, [&](size_t first, size_t last){
+		for(size_t k = first; k < last; k++){
+			size_t from = k * block, length = min(block, n - from);
+			if(carryIn[k])
+				limbAddCarry(r + from, r + from, length, T(1));
+		}
+	});
+	return carry;
+}
+
+//r = a - b - borrow over n limbs like simdSubN, split into blocks once n is large enough
+template <typename T>
+T parallelSubN(T *r, const T *a, const T *b, size_t n, T borrow = 0){
+	const ParallelThresholds &thresholds = parallelThresholds();
+	if(n < thresholds.add || parallelThreads() < 2)
+		return simdSubN(r, a, b, n, borrow);
+	size_t block = max(thresholds.addBlock, size_t(1));
+	size_t blocks = (n + block - 1) / block;
+	Vector<unsigned char> generate(blocks), propagate(blocks);
+	parallelPool().parallelFor(0, blocks, 1, [&](size_t first, size_t last){
+		for(size_t k = first; k < last; k++){
+			size_t from = k * block, length = min(block, n - from);
+			T *limbs = r + from;
+			generate[k] = static_cast<unsigned char>(simdSubN(limbs, a + from, b + from, length));
+			propagate[k] = (find_if(limbs, limbs + length, [](T limb){ return limb != 0; }) == limbs + length);
+		}
+	});
+	Vector<unsigned char> borrowIn(blocks);
+	for(size_t k = 0; k < blocks; k++){
+		borrowIn[k] = static_cast<unsigned char>(borrow);
+		borrow = (generate[k] || (borrow && propagate[k]));
+	}
+	parallelPool().parallelFor(0, blocks, 1, [&](size_t first, size_t last){
+		for(size_t k = first; k < last; k++){
+			size_t from = k * block, length = min(block, n - from);
+			if(borrowIn[k])
+				limbSubBorrow(r + from, r + from, length, T(1));
+		}
+	});
+	return borrow;
+}
+
+#endif
@@ -0,0 +1,77 @@
+#ifndef PIPELINE_H
+#define PIPELINE_H
+
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <utility>
+
+using namespace std;
+
+/* A bounded first in, first out queue between the threads of a pipeline.
+ * push() blocks while the queue is full, so a fast stage can't run far
+ * ahead of a slow one, and pop() blocks while it is empty. Once the
+ * producer close()s it, pop() hands out what is left, then returns false.
+ */
+template <typename T>
+class BlockingQueue{
+  public:
+	explicit BlockingQueue(size_t capacity);
+	BlockingQueue(const BlockingQueue<T>&) = delete;
+	BlockingQueue<T>& operator=(const BlockingQueue<T>&) = delete;
+	bool push(T &&item);
+	bool pop(T &item);
+	void close();
+
+  private:
+	deque<T> items;
+	size_t capacity;
+	bool closed;
+	mutex lock;
+	condition_variable notEmpty;
+	condition_variable notFull;
+}; //BlockingQueue class
+
+template <typename T>
+BlockingQueue<T>::BlockingQueue(size_t capacity):capacity{capacity > 0? capacity: 1},closed{false}{}
+
+//waits for room, returns false (dropping 'item') if the queue was closed
+template <typename T>
+bool BlockingQueue<T>::push(T &&item){
+	unique_lock<mutex> guard(lock);
+	notFull.wait(guard, [this]{ return closed || items.size() < capacity; });
+	if(closed)
+		return false;
+	items.push_back(std::move(item));
+	guard.unlock();
+	notEmpty.notify_one();
+	return true;
+}
+
+//waits for an item, returns false once the queue is closed and empty
+template <typename T>
+bool BlockingQueue<T>::pop(T &item){
+	unique_lock<mutex> guard(lock);
+	notEmpty.wait(guard, [this]{ return closed || !items.empty(); });
+	if(items.empty())
+		return false;
+	item = std::move(items.front());
+	items.pop_front();
+	guard.unlock();
+	notFull.notify_one();
+	return true;
+}
+
+//no more items will be pushed; wakes every thread that waits
+template <typename T>
+void BlockingQueue<T>::close(){
+	{
+		lock_guard<mutex> guard(lock);
+		closed = true;
+	}
+	notEmpty.notify_all();
+	notFull.notify_all();
+}
+
+#endif
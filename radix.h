@@ -0,0 +1,180 @@
+#ifndef RADIX_H
+#define RADIX_H
+
+#include "limb.h"
+#include "multiply.h"
+#include "divide.h"
+#include "vector.h"
+#include <cstddef>
+
+/* Conversion between decimal digit strings and binary limbs (see limb.h).
+ * Short numbers are converted a CHUNK at a time, by multiplying the chunks
+ * in (value = value*10^len + chunk) or by dividing them out, which is
+ * quadratic. Longer ones are split at a power CHUNK^(2^j) into a high and a
+ * low part, with a single multiplication (value = high*CHUNK^(2^j) + low) or
+ * division (high, low = divmod(value, CHUNK^(2^j))), and the parts are
+ * converted separately, so a conversion costs about log(n)
+ * multiplications of its size. The powers are made by repeated squaring,
+ * and cached for the following conversions.
+ *
+ * The defaults can be changed when compiling (-DBIGINT_FROM_DECIMAL_THRESHOLD=...)
+ * or at runtime through radixThresholds().
+ */
+
+#ifndef BIGINT_FROM_DECIMAL_THRESHOLD
+#define BIGINT_FROM_DECIMAL_THRESHOLD 40
+#endif
+
+#ifndef BIGINT_TO_DECIMAL_THRESHOLD
+#define BIGINT_TO_DECIMAL_THRESHOLD 40
+#endif
+
+struct RadixThresholds{
+	size_t fromDecimal; //longest digit string (in CHUNKs) read without splitting it
+	size_t toDecimal; //longest digit string (in CHUNKs) written without splitting it
+};
+
+inline RadixThresholds& radixThresholds() noexcept{
+	static RadixThresholds thresholds = {BIGINT_FROM_DECIMAL_THRESHOLD,
+										 BIGINT_TO_DECIMAL_THRESHOLD};
+	return thresholds;
+}
+
+//binary limbs enough for a 'digits' long decimal number, as a decimal digit is log2(10) < 3.322 bits
+template <typename T>
+size_t radixLimbs(size_t digits) noexcept{
+	return digits * 3322 / 1000 / (8 * sizeof(T)) + 1;
+}
+
+//decimal digits enough for 'n' binary limbs, as a bit is log10(2) < 0.30103 decimal digits
+template <typename T>
+size_t radixDigits(size_t n) noexcept{
+	return n * 8 * sizeof(T) * 30103 / 100000 + 1;
+}
+
+//writes 'value' as exactly 'length' digits, with leading 0's
+inline void radixPutDigits(char *digits, size_t length, unsigned long long value) noexcept{
+	while(length-- > 0){
+		digits[length] = static_cast<char>('0' + value % 10);
+		value /= 10;
+	}
+}
+
+//CHUNK^(2^j), without leading 0 limbs; each thread keeps the powers it made so far.
+//They outlive any MemoryBudget, so they are charged to none: the budgets in scope
+//only have to have room for a power (and its copy in the table) while it is made
+template <typename T>
+const Vector<T>& radixPower(size_t j){
+	static thread_local Vector<Vector<T>> powers(0);
+	while(powers.size() <= j){
+		size_t bytes = 2 * sizeof(T) * (powers.empty()? 1: 2 * powers.back().size());
+		memoryBudgetCharge(bytes);
+		memoryBudgetCredit(bytes);
+		MemoryBudgetScope none(nullptr);
+		Vector<T> power;
+		if(powers.empty())
+			power.push_back(static_cast<T>(LimbTraits<T>::CHUNK));
+		else{
+			const Vector<T> &last = powers.back();
+			power = Vector<T>(2 * last.size());
+			limbMul(power.begin(), last.begin(), last.size(), last.begin(), last.size());
+			while(power.back() == 0)
+				power.pop_back();
+		}
+		powers.push_back(power);
+	}
+	return powers[j];
+}
+
+//the decimal number in digits[0, length) as little-endian binary limbs, without leading 0 limbs
+template <typename T>
+Vector<T> radixFromDecimal(const char *digits, size_t length){
+	typedef LimbTraits<T> Traits;
+	const size_t CHUNK_DIGITS = Traits::CHUNK_DIGITS;
+	size_t chunks = (length + CHUNK_DIGITS - 1) / CHUNK_DIGITS;
+	if(chunks <= radixThresholds().fromDecimal || chunks < 2){
+		Vector<T> value(radixLimbs<T>(length));
+		T *limbs = value.begin();
+		size_t count = 0, first = 0;
+		while(first < length){
+			size_t piece = (length - first) % CHUNK_DIGITS;
+			if(piece == 0)
+				piece = CHUNK_DIGITS;
+			unsigned long long chunk = 0;
+			for(size_t i = first; i < first + piece; i++)
+				chunk = chunk * 10 + (digits[i] - '0');
+			//value*10^piece + chunk < BASE^(count+1), so the top limb can't overflow
+			T top = limbMulSmall(limbs, limbs, count, static_cast<T>(limbPow10(piece)));
+			top += limbAddCarry(limbs, limbs, count, static_cast<T>(chunk));
+			if(top != 0)
+				limbs[count++] = top;
+			first += piece;
+		}
+		while(value.size() > count)
+			value.pop_back();
+		return value;
+	}
+	size_t j = 0; //the low part is the largest 2^j chunks that leave a high part
+	while((size_t(2) << j) < chunks)
+		++j;
+	size_t lowDigits = CHUNK_DIGITS << j;
+	Vector<T> high = radixFromDecimal<T>(digits, length - lowDigits);
+	Vector<T> low = radixFromDecimal<T>(digits + length - lowDigits, lowDigits);
+	if(high.empty())
+		return low;
+	const Vector<T> &power = radixPower<T>(j);
+	Vector<T> value(high.size() + power.size());
+	T *limbs = value.begin();
+	limbMul(limbs, high.begin(), high.size(), power.begin(), power.size());
+	T carry = limbAddN(limbs, limbs, low.begin(), low.size()); //low < power, so it fits below the top
+	limbAddCarry(limbs + low.size(), limbs + low.size(), value.size() - low.size(), carry);
+	while(value.back() == 0)
+		value.pop_back();
+	return value;
+}
+
+//writes the n limbs of 'a' as exactly 'length' decimal digits, with leading 0's; a < 10^length
+template <typename T>
+void radixToDecimal(const T *a, size_t n, char *digits, size_t length){
+	typedef LimbTraits<T> Traits;
+	const size_t CHUNK_DIGITS = Traits::CHUNK_DIGITS;
+	n = limbNormalize(a, n);
+	size_t chunks = (length + CHUNK_DIGITS - 1) / CHUNK_DIGITS;
+	if(n == 0){
+		std::fill(digits, digits + length, '0');
+		return;
+	}
+	if(chunks <= radixThresholds().toDecimal || chunks < 2){ //chunks are divided out from the bottom
+		Vector<T> value(n);
+		T *limbs = value.begin();
+		std::copy(a, a + n, limbs);
+		size_t last = length;
+		while(last > 0){
+			size_t piece = std::min(last, CHUNK_DIGITS);
+			unsigned long long chunk = 0;
+			if(n > 0){
+				chunk = static_cast<unsigned long long>(limbDivSmall(limbs, limbs, n, static_cast<T>(Traits::CHUNK)));
+				n = limbNormalize(limbs, n);
+			}
+			radixPutDigits(digits + last - piece, piece, chunk);
+			last -= piece;
+		}
+		return;
+	}
+	size_t j = 0; //the low part is the largest 2^j chunks that leave a high part
+	while((size_t(2) << j) < chunks)
+		++j;
+	size_t lowDigits = CHUNK_DIGITS << j;
+	const Vector<T> &power = radixPower<T>(j);
+	if(n < power.size()){ //a < power, so the high part is all 0's
+		std::fill(digits, digits + length - lowDigits, '0');
+		radixToDecimal(a, n, digits + length - lowDigits, lowDigits);
+		return;
+	}
+	Vector<T> high(n - power.size() + 1), low(power.size());
+	limbDivmod(high.begin(), low.begin(), a, n, power.begin(), power.size());
+	radixToDecimal(high.begin(), high.size(), digits, length - lowDigits);
+	radixToDecimal(low.begin(), low.size(), digits + length - lowDigits, lowDigits);
+}
+
+#endif
@@ -0,0 +1,141 @@
+#ifndef SERIALIZE_H
+#define SERIALIZE_H
+
+#include "limb.h"
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <type_traits>
+
+/* The binary format of a BigInt, for checkpoints that skip the radix
+ * conversion of the decimal text format:
+ *
+ *   offset  size
+ *        0     4  magic "BGNT"
+ *        4     1  version of the format, SERIAL_VERSION
+ *        5     1  sign, 1 for positive or 0, 0 for negative
+ *        6     1  limb size in bytes
+ *        7     1  limb kind, 1 for binary limbs (base 2^n), 0 for decimal ones (base 10^k)
+ *        8     8  limb count
+ *       16     8  checksum of the limbs, see serialChecksum
+ *       24        the limbs, least significant first
+ *
+ * Every field and limb is little-endian, and the limbs start 8 bytes into
+ * an 8 byte aligned buffer, so on a little-endian machine they are copied
+ * (or read out of a mapped file) as they are. The checksum catches
+ * truncated and corrupted files, it isn't meant to stop forgeries; the
+ * limbs are checked on their own (each below the base, the top one not 0),
+ * so that no input makes a BigInt the arithmetic can't work with.
+ */
+
+const char SERIAL_MAGIC[4] = {'B', 'G', 'N', 'T'};
+const unsigned char SERIAL_VERSION = 1;
+const size_t SERIAL_HEADER = 24;
+const size_t SERIAL_PIECE = size_t(1) << 20; //bytes a stream is read in at a time, so a forged count can't allocate more than arrives
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+const bool SERIAL_NATIVE = false; //limbs have to be byte swapped
+#else
+const bool SERIAL_NATIVE = true;
+#endif
+
+struct SerialHeader{
+	bool sign;
+	unsigned limbSize;
+	bool binary;
+	uint64_t count;
+	uint64_t checksum;
+};
+
+inline void serialPut64(char *bytes, uint64_t value) noexcept{
+	for(int i = 0; i < 8; i++)
+		bytes[i] = static_cast<char>(value >> (8 * i));
+}
+
+inline uint64_t serialGet64(const char *bytes) noexcept{
+	uint64_t value = 0;
+	for(int i = 0; i < 8; i++)
+		value |= uint64_t(static_cast<unsigned char>(bytes[i])) << (8 * i);
+	return value;
+}
+
+//two running sums of the little-endian 32 bit words (the last one padded with 0's), mixed together
+inline uint64_t serialChecksum(const char *bytes, size_t length) noexcept{
+	uint64_t sum = 0, sumOfSums = 0;
+	size_t i = 0;
+	for(; i + 4 <= length; i += 4){
+		uint32_t word = uint32_t(static_cast<unsigned char>(bytes[i]))
+					  | uint32_t(static_cast<unsigned char>(bytes[i+1])) << 8
+					  | uint32_t(static_cast<unsigned char>(bytes[i+2])) << 16
+					  | uint32_t(static_cast<unsigned char>(bytes[i+3])) << 24;
+		sum += word;
+		sumOfSums += sum;
+	}
+	if(i < length){
+		uint32_t word = 0;
+		for(size_t j = 0; i + j < length; j++)
+			word |= uint32_t(static_cast<unsigned char>(bytes[i+j])) << (8 * j);
+		sum += word;
+		sumOfSums += sum;
+	}
+	return (sumOfSums * 0x9E3779B97F4A7C15ULL) ^ sum ^ length;
+}
+
+inline void serialStoreHeader(char *bytes, const SerialHeader &header) noexcept{
+	memcpy(bytes, SERIAL_MAGIC, 4);
+	bytes[4] = static_cast<char>(SERIAL_VERSION);
+	bytes[5] = static_cast<char>(header.sign);
+	bytes[6] = static_cast<char>(header.limbSize);
+	bytes[7] = static_cast<char>(header.binary);
+	serialPut64(bytes + 8, header.count);
+	serialPut64(bytes + 16, header.checksum);
+}
+
+inline SerialHeader serialLoadHeader(const char *bytes){
+	if(memcmp(bytes, SERIAL_MAGIC, 4) != 0)
+		throw std::invalid_argument("serialLoadHeader: error! tried reading something that isn't a serialized BigInt");
+	if(static_cast<unsigned char>(bytes[4]) != SERIAL_VERSION)
+		throw std::invalid_argument("serialLoadHeader: error! tried reading an unsupported version of the format");
+	SerialHeader header;
+	header.sign = (bytes[5] != 0);
+	header.limbSize = static_cast<unsigned char>(bytes[6]);
+	header.binary = (bytes[7] != 0);
+	header.count = serialGet64(bytes + 8);
+	header.checksum = serialGet64(bytes + 16);
+	return header;
+}
+
+//copies n limbs to or from their little-endian bytes
+template <typename T>
+void serialStoreLimbs(char *bytes, const T *limbs, size_t n) noexcept{
+	if(SERIAL_NATIVE){
+		if(n > 0)
+			memcpy(bytes, limbs, n * sizeof(T));
+		return;
+	}
+	typedef typename std::make_unsigned<T>::type Unsigned;
+	for(size_t i = 0; i < n; i++){
+		Unsigned limb = static_cast<Unsigned>(limbs[i]);
+		for(size_t j = 0; j < sizeof(T); j++)
+			*(bytes++) = static_cast<char>(static_cast<unsigned long long>(limb) >> (8 * j));
+	}
+}
+
+template <typename T>
+void serialLoadLimbs(T *limbs, const char *bytes, size_t n) noexcept{
+	if(SERIAL_NATIVE){
+		if(n > 0)
+			memcpy(limbs, bytes, n * sizeof(T));
+		return;
+	}
+	typedef typename std::make_unsigned<T>::type Unsigned;
+	for(size_t i = 0; i < n; i++){
+		unsigned long long limb = 0;
+		for(size_t j = 0; j < sizeof(T); j++)
+			limb |= static_cast<unsigned long long>(static_cast<unsigned char>(*(bytes++))) << (8 * j);
+		limbs[i] = static_cast<T>(static_cast<Unsigned>(limb));
+	}
+}
+
+#endif
@@ -0,0 +1,398 @@
+#ifndef SIMD_H
+#define SIMD_H
+
+#include "limb.h"
+
+/* Vectorized kernels for contiguous little-endian limb arrays, as stored by
+ * BigInt<T,Vector>: addition and subtraction with carry/borrow, comparison
+ * and equality. The instruction set is picked once at runtime (AVX-512,
+ * AVX2, or the scalar kernels of limb.h), and can be changed through
+ * simdLevel(). Compiling with -DBIGINT_NO_SIMD, or for a non-x86 target,
+ * always uses the scalar kernels.
+ *
+ * Carries are resolved a whole vector at a time (carry-select): every lane
+ * reports whether it generates a carry (its sum overflowed the limb) and
+ * whether it would propagate an incoming one (its sum is the largest limb).
+ * Adding the generate bits, shifted up one lane, to the propagate bits
+ * ripples the carries through the mask in one integer addition, and the
+ * bits that changed are the lanes that receive a carry. Borrows work the
+ * same way, with 0 being the limb that propagates.
+ *
+ * Add and subtract are vectorized for 4 and 8 byte limbs; compare and
+ * equality work on bytes, so they cover every limb type.
+ */
+
+#if !defined(BIGINT_NO_SIMD) && defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define BIGINT_SIMD 1
+#include <immintrin.h>
+#define BIGINT_AVX2 __attribute__((target("avx2")))
+#define BIGINT_AVX512 __attribute__((target("avx512f,avx512bw")))
+#else
+#define BIGINT_SIMD 0
+#endif
+
+enum SimdLevel{ SIMD_SCALAR, SIMD_AVX2, SIMD_AVX512 };
+
+inline SimdLevel simdDetect() noexcept{
+#if BIGINT_SIMD
+	__builtin_cpu_init();
+	if(__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw"))
+		return SIMD_AVX512;
+	if(__builtin_cpu_supports("avx2"))
+		return SIMD_AVX2;
+#endif
+	return SIMD_SCALAR;
+}
+
+//instruction set used by the kernels below, never set it higher than simdDetect()
+inline SimdLevel& simdLevel() noexcept{
+	static SimdLevel level = simdDetect();
+	return level;
+}
+
+#if BIGINT_SIMD
+
+/////////////////////////// LANES /////////////////////////////////////////////
+/* Lane operations for BYTES wide limbs; masks hold one bit per lane. */
+
+template <size_t BYTES> struct Avx2Lanes;
+
+template <> struct Avx2Lanes<4>{
+	typedef __m256i Vec;
+	static constexpr unsigned COUNT = 8;
+	BIGINT_AVX2 static Vec load(const void *p){ return _mm256_loadu_si256(static_cast<const __m256i*>(p)); }
+	BIGINT_AVX2 static void store(void *p, Vec v){ _mm256_storeu_si256(static_cast<__m256i*>(p), v); }
+	BIGINT_AVX2 static Vec set1(unsigned long long v){ return _mm256_set1_epi32(static_cast<int>(v)); }
+	BIGINT_AVX2 static Vec add(Vec a, Vec b){ return _mm256_add_epi32(a, b); }
+	BIGINT_AVX2 static Vec sub(Vec a, Vec b){ return _mm256_sub_epi32(a, b); }
+	BIGINT_AVX2 static unsigned equal(Vec a, Vec b){
+		return _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(a, b)));
+	}
+	BIGINT_AVX2 static unsigned less(Vec a, Vec b){ //unsigned a < b
+		const Vec flip = set1(0x80000000ULL);
+		return _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(_mm256_xor_si256(b, flip), _mm256_xor_si256(a, flip))));
+	}
+	BIGINT_AVX2 static Vec select(unsigned mask){ //all ones in the lanes of 'mask'
+		const Vec bits = _mm256_setr_epi32(1, 2, 4, 8, 16, 32, 64, 128);
+		return _mm256_cmpeq_epi32(_mm256_and_si256(set1(mask), bits), bits);
+	}
+	BIGINT_AVX2 static Vec maskAdd(Vec a, unsigned mask, Vec b){ return add(a, _mm256_and_si256(select(mask), b)); }
+	BIGINT_AVX2 static Vec maskSub(Vec a, unsigned mask, Vec b){ return sub(a, _mm256_and_si256(select(mask), b)); }
+};
+
+template <> struct Avx2Lanes<8>{
+	typedef __m256i Vec;
+	static constexpr unsigned COUNT = 4;
+	BIGINT_AVX2 static Vec load(const void *p){ return _mm256_loadu_si256(static_cast<const __m256i*>(p)); }
+	BIGINT_AVX2 static void store(void *p, Vec v){ _mm256_storeu_si256(static_cast<__m256i*>(p), v); }
+	BIGINT_AVX2 static Vec set1(unsigned long long v){ return _mm256_set1_epi64x(static_cast<long long>(v)); }
+	BIGINT_AVX2 static Vec add(Vec a, Vec b){ return _mm256_add_epi64(a, b); }
+	BIGINT_AVX2 static Vec sub(Vec a, Vec b){ return _mm256_sub_epi64(a, b); }
+	BIGINT_AVX2 static unsigned equal(Vec a, Vec b){
+		return _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(a, b)));
+	}
+	BIGINT_AVX2 static unsigned less(Vec a, Vec b){ //unsigned a < b
+		const Vec flip = set1(0x8000000000000000ULL);
+		return _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpgt_epi64(_mm256_xor_si256(b, flip), _mm256_xor_si256(a, flip))));
+	}
+	BIGINT_AVX2 static Vec select(unsigned mask){ //all ones in the lanes of 'mask'
+		const Vec bits = _mm256_setr_epi64x(1, 2, 4, 8);
+		return _mm256_cmpeq_epi64(_mm256_and_si256(set1(mask), bits), bits);
+	}
+	BIGINT_AVX2 static Vec maskAdd(Vec a, unsigned mask, Vec b){ return add(a, _mm256_and_si256(select(mask), b)); }
+	BIGINT_AVX2 static Vec maskSub(Vec a, unsigned mask, Vec b){ return sub(a, _mm256_and_si256(select(mask), b)); }
+};
+
+template <size_t BYTES> struct Avx512Lanes;
+
+template <> struct Avx512Lanes<4>{
+	typedef __m512i Vec;
+	static constexpr unsigned COUNT = 16;
+	BIGINT_AVX512 static Vec load(const void *p){ return _mm512_loadu_si512(p); }
+	BIGINT_AVX512 static void store(void *p, Vec v){ _mm512_storeu_si512(p, v); }
+	BIGINT_AVX512 static Vec set1(unsigned long long v){ return _mm512_set1_epi32(static_cast<int>(v)); }
+	BIGINT_AVX512 static Vec add(Vec a, Vec b){ return _mm512_add_epi32(a, b); }
+	BIGINT_AVX512 static Vec sub(Vec a, Vec b){ return _mm512_sub_epi32(a, b); }
+	BIGINT_AVX512 static unsigned equal(Vec a, Vec b){ return _mm512_cmpeq_epi32_mask(a, b); }
+	BIGINT_AVX512 static unsigned less(Vec a, Vec b){ return _mm512_cmplt_epu32_mask(a, b); }
+	BIGINT_AVX512 static Vec maskAdd(Vec a, unsigned mask, Vec b){ return _mm512_mask_add_epi32(a, static_cast<__mmask16>(mask), a, b); }
+	BIGINT_AVX512 static Vec maskSub(Vec a, unsigned mask, Vec b){ return _mm512_mask_sub_epi32(a, static_cast<__mmask16>(mask), a, b); }
+};
+
+template <> struct Avx512Lanes<8>{
+	typedef __m512i Vec;
+	static constexpr unsigned COUNT = 8;
+	BIGINT_AVX512 static Vec load(const void *p){ return _mm512_loadu_si512(p); }
+	BIGINT_AVX512 static void store(void *p, Vec v){ _mm512_storeu_si512(p, v); }
+	BIGINT_AVX512 static Vec set1(unsigned long long v){ return _mm512_set1_epi64(static_cast<long long>(v)); }
+	BIGINT_AVX512 static Vec add(Vec a, Vec b){ return _mm512_add_epi64(a, b); }
+	BIGINT_AVX512 static Vec sub(Vec a, Vec b){ return _mm512_sub_epi64(a, b); }
+	BIGINT_AVX512 static unsigned equal(Vec a, Vec b){ return _mm512_cmpeq_epi64_mask(a, b); }
+	BIGINT_AVX512 static unsigned less(Vec a, Vec b){ return _mm512_cmplt_epu64_mask(a, b); }
+	BIGINT_AVX512 static Vec maskAdd(Vec a, unsigned mask, Vec b){ return _mm512_mask_add_epi64(a, static_cast<__mmask8>(mask), a, b); }
+	BIGINT_AVX512 static Vec maskSub(Vec a, unsigned mask, Vec b){ return _mm512_mask_sub_epi64(a, static_cast<__mmask8>(mask), a, b); }
+};
+
+/////////////////////////// ADD / SUBTRACT ////////////////////////////////////
+/* Each kernel handles the whole vectors of the n limbs and returns the carry
+ * (borrow) out of them; the remaining n % COUNT limbs are left to the caller.
+ * The AVX2 and AVX-512 versions only differ in their lanes and target.
+ */
+
+//value of the largest limb, which propagates a carry
+template <typename T>
+unsigned long long simdTopLimb() noexcept{
+	return (LimbTraits<T>::BINARY? ~0ULL: static_cast<unsigned long long>(LimbTraits<T>::BASE - 1));
+}
+
+template <typename T>
+BIGINT_AVX2 T avx2AddN(T *r, const T *a, const T *b, size_t n, T carry){
+	typedef Avx2Lanes<sizeof(T)> L;
+	const typename L::Vec top = L::set1(simdTopLimb<T>()), one = L::set1(1);
+	const typename L::Vec base = L::set1(static_cast<unsigned long long>(LimbTraits<T>::BASE)); //0 for binary limbs
+	unsigned carryIn = carry;
+	for(size_t i = 0; i + L::COUNT <= n; i += L::COUNT){
+		typename L::Vec x = L::load(a + i), sum = L::add(x, L::load(b + i));
+		unsigned generate = (LimbTraits<T>::BINARY? L::less(sum, x): L::less(top, sum));
+		unsigned propagate = L::equal(sum, top);
+		unsigned ripple = (generate << 1) + propagate + carryIn;
+		unsigned incoming = (ripple ^ propagate) & ((1u << L::COUNT) - 1);
+		carryIn = ripple >> L::COUNT;
+		sum = L::maskAdd(sum, incoming, one);
+		if(!LimbTraits<T>::BINARY)
+			sum = L::maskSub(sum, L::less(top, sum), base);
+		L::store(r + i, sum);
+	}
+	return static_cast<T>(carryIn);
+}
+
+template <typename T>
+BIGINT_AVX2 T avx2SubN(T *r, const T *a, const T *b, size_t n, T borrow){
+	typedef Avx2Lanes<sizeof(T)> L;
+	const typename L::Vec zero = L::set1(0), one = L::set1(1);
+	const typename L::Vec base = L::set1(static_cast<unsigned long long>(LimbTraits<T>::BASE));
+	unsigned borrowIn = borrow;
+	for(size_t i = 0; i + L::COUNT <= n; i += L::COUNT){
+		typename L::Vec x = L::load(a + i), y = L::load(b + i), difference = L::sub(x, y);
+		unsigned generate = L::less(x, y);
+		if(!LimbTraits<T>::BINARY)
+			difference = L::maskAdd(difference, generate, base);
+		unsigned propagate = L::equal(difference, zero);
+		unsigned ripple = (generate << 1) + propagate + borrowIn;
+		unsigned incoming = (ripple ^ propagate) & ((1u << L::COUNT) - 1);
+		borrowIn = ripple >> L::COUNT;
+		difference = L::maskSub(difference, incoming, one);
+		if(!LimbTraits<T>::BINARY) //0 - 1 wraps around to BASE - 1
+			difference = L::maskAdd(difference, incoming & propagate, base);
+		L::store(r + i, difference);
+	}
+	return static_cast<T>(borrowIn);
+}
+
+template <typename T>
+BIGINT_AVX512 T avx512AddN(T *r, const T *a, const T *b, size_t n, T carry){
+	typedef Avx512Lanes<sizeof(T)> L;
+	const typename L::Vec top = L::set1(simdTopLimb<T>()), one = L::set1(1);
+	const typename L::Vec base = L::set1(static_cast<unsigned long long>(LimbTraits<T>::BASE));
+	unsigned carryIn = carry;
+	for(size_t i = 0; i + L::COUNT <= n; i += L::COUNT){
+		typename L::Vec x = L::load(a + i), sum = L::add(x, L::load(b + i));
+		unsigned generate = (LimbTraits<T>::BINARY? L::less(sum, x): L::less(top, sum));
+		unsigned propagate = L::equal(sum, top);
+		unsigned ripple = (generate << 1) + propagate + carryIn;
+		unsigned incoming = (ripple ^ propagate) & ((1u << L::COUNT) - 1);
+		carryIn = ripple >> L::COUNT;
+		sum = L::maskAdd(sum, incoming, one);
+		if(!LimbTraits<T>::BINARY)
+			sum = L::maskSub(sum, L::less(top, sum), base);
+		L::store(r + i, sum);
+	}
+	return static_cast<T>(carryIn);
+}
+
+template <typename T>
+BIGINT_AVX512 T avx512SubN(T *r, const T *a, const T *b, size_t n, T borrow){
+	typedef Avx512Lanes<sizeof(T)> L;
+	const typename L::Vec zero = L::set1(0), one = L::set1(1);
+	const typename L::Vec base = L::set1(static_cast<unsigned long long>(LimbTraits<T>::BASE));
+	unsigned borrowIn = borrow;
+	for(size_t i = 0; i + L::COUNT <= n; i += L::COUNT){
+		typename L::Vec x = L::load(a + i), y = L::load(b + i), difference = L::sub(x, y);
+		unsigned generate = L::less(x, y);
+		if(!LimbTraits<T>::BINARY)
+			difference = L::maskAdd(difference, generate, base);
+		unsigned propagate = L::equal(difference, zero);
+		unsigned ripple = (generate << 1) + propagate + borrowIn;
+		unsigned incoming = (ripple ^ propagate) & ((1u << L::COUNT) - 1);
+		borrowIn = ripple >> L::COUNT;
+		difference = L::maskSub(difference, incoming, one);
+		if(!LimbTraits<T>::BINARY) //0 - 1 wraps around to BASE - 1
+			difference = L::maskAdd(difference, incoming & propagate, base);
+		L::store(r + i, difference);
+	}
+	return static_cast<T>(borrowIn);
+}
+
+/////////////////////////// COMPARE / EQUAL ///////////////////////////////////
+/* These work on the bytes of the limbs, so any limb size is covered; a
+ * difference is located by its byte and settled by comparing its limb.
+ */
+
+template <typename T>
+BIGINT_AVX2 bool avx2Equal(const T *a, const T *b, size_t n){
+	const char *x = reinterpret_cast<const char*>(a), *y = reinterpret_cast<const char*>(b);
+	size_t bytes = n * sizeof(T), i = 0;
+	for(; i + 32 <= bytes; i += 32){
+		__m256i equal = _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(x + i)),
+										  _mm256_loadu_si256(reinterpret_cast<const __m256i*>(y + i)));
+		if(static_cast<unsigned>(_mm256_movemask_epi8(equal)) != 0xFFFFFFFFu)
+			return false;
+	}
+	for(size_t limb = i / sizeof(T); limb < n; limb++){
+		if(a[limb] != b[limb])
+			return false;
+	}
+	return true;
+}
+
+//returns the limb (counted from a and b) the top difference is in, or n if there is none
+template <typename T>
+BIGINT_AVX2 size_t avx2TopDifference(const T *a, const T *b, size_t n){
+	const char *x = reinterpret_cast<const char*>(a), *y = reinterpret_cast<const char*>(b);
+	size_t end = n * sizeof(T);
+	for(; end >= 32; end -= 32){
+		__m256i equal = _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(x + end - 32)),
+										  _mm256_loadu_si256(reinterpret_cast<const __m256i*>(y + end - 32)));
+		unsigned differ = ~static_cast<unsigned>(_mm256_movemask_epi8(equal));
+		if(differ != 0)
+			return (end - 32 + 31 - __builtin_clz(differ)) / sizeof(T);
+	}
+	for(size_t limb = end / sizeof(T); limb-- > 0;){
+		if(a[limb] != b[limb])
+			return limb;
+	}
+	return n;
+}
+
+template <typename T>
+BIGINT_AVX512 bool avx512Equal(const T *a, const T *b, size_t n){
+	const char *x = reinterpret_cast<const char*>(a), *y = reinterpret_cast<const char*>(b);
+	size_t bytes = n * sizeof(T), i = 0;
+	for(; i + 64 <= bytes; i += 64){
+		if(_mm512_cmpneq_epi8_mask(_mm512_loadu_si512(x + i), _mm512_loadu_si512(y + i)) != 0)
+			return false;
+	}
+	for(size_t limb = i / sizeof(T); limb < n; limb++){
+		if(a[limb] != b[limb])
+			return false;
+	}
+	return true;
+}
+
+template <typename T>
+BIGINT_AVX512 size_t avx512TopDifference(const T *a, const T *b, size_t n){
+	const char *x = reinterpret_cast<const char*>(a), *y = reinterpret_cast<const char*>(b);
+	size_t end = n * sizeof(T);
+	for(; end >= 64; end -= 64){
+		unsigned long long differ = _mm512_cmpneq_epi8_mask(_mm512_loadu_si512(x + end - 64), _mm512_loadu_si512(y + end - 64));
+		if(differ != 0)
+			return (end - 64 + 63 - __builtin_clzll(differ)) / sizeof(T);
+	}
+	for(size_t limb = end / sizeof(T); limb-- > 0;){
+		if(a[limb] != b[limb])
+			return limb;
+	}
+	return n;
+}
+
+#endif //BIGINT_SIMD
+
+/////////////////////////// DISPATCH //////////////////////////////////////////
+
+//add and subtract kernels by limb size, they return how many limbs they did
+template <typename T, bool WORD = (sizeof(T) == 4 || sizeof(T) == 8)>
+struct SimdCarryKernels{
+	static size_t addN(T*, const T*, const T*, size_t, T&) noexcept{ return 0; }
+	static size_t subN(T*, const T*, const T*, size_t, T&) noexcept{ return 0; }
+};
+
+#if BIGINT_SIMD
+template <typename T>
+struct SimdCarryKernels<T, true>{
+	static size_t addN(T *r, const T *a, const T *b, size_t n, T &carry) noexcept{
+		if(simdLevel() == SIMD_AVX512){
+			carry = avx512AddN(r, a, b, n, carry);
+			return n - n % Avx512Lanes<sizeof(T)>::COUNT;
+		}
+		if(simdLevel() == SIMD_AVX2){
+			carry = avx2AddN(r, a, b, n, carry);
+			return n - n % Avx2Lanes<sizeof(T)>::COUNT;
+		}
+		return 0;
+	}
+	static size_t subN(T *r, const T *a, const T *b, size_t n, T &borrow) noexcept{
+		if(simdLevel() == SIMD_AVX512){
+			borrow = avx512SubN(r, a, b, n, borrow);
+			return n - n % Avx512Lanes<sizeof(T)>::COUNT;
+		}
+		if(simdLevel() == SIMD_AVX2){
+			borrow = avx2SubN(r, a, b, n, borrow);
+			return n - n % Avx2Lanes<sizeof(T)>::COUNT;
+		}
+		return 0;
+	}
+};
+#endif
+
+//r = a + b + carry over n limbs, returns the carry out of the top limb
+template <typename T>
+T simdAddN(T *r, const T *a, const T *b, size_t n, T carry = 0) noexcept{
+	size_t done = SimdCarryKernels<T>::addN(r, a, b, n, carry);
+	return limbAddN(r + done, a + done, b + done, n - done, carry);
+}
+
+//r = a - b - borrow over n limbs, returns the borrow out of the top limb
+template <typename T>
+T simdSubN(T *r, const T *a, const T *b, size_t n, T borrow = 0) noexcept{
+	size_t done = SimdCarryKernels<T>::subN(r, a, b, n, borrow);
+	return limbSubN(r + done, a + done, b + done, n - done, borrow);
+}
+
+//whether the n limbs of a and b are all equal
+template <typename T>
+bool simdEqual(const T *a, const T *b, size_t n) noexcept{
+#if BIGINT_SIMD
+	if(simdLevel() == SIMD_AVX512)
+		return avx512Equal(a, b, n);
+	if(simdLevel() == SIMD_AVX2)
+		return avx2Equal(a, b, n);
+#endif
+	for(size_t i = 0; i < n; i++){
+		if(a[i] != b[i])
+			return false;
+	}
+	return true;
+}
+
+//returns -1, 0 or 1 as a is less than, equal to or greater than b, both n limbs long
+template <typename T>
+int simdCompare(const T *a, const T *b, size_t n) noexcept{
+	size_t limb = n;
+#if BIGINT_SIMD
+	if(simdLevel() == SIMD_AVX512)
+		limb = avx512TopDifference(a, b, n);
+	else if(simdLevel() == SIMD_AVX2)
+		limb = avx2TopDifference(a, b, n);
+	else
+#endif
+	{
+		while(limb > 0 && a[limb-1] == b[limb-1])
+			--limb;
+		limb = (limb > 0? limb - 1: n);
+	}
+	if(limb == n)
+		return 0;
+	return (a[limb] > b[limb]? 1: -1);
+}
+
+#endif
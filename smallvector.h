@@ -0,0 +1,265 @@
+#ifndef SMALLVECTOR_H
+#define SMALLVECTOR_H
+
+#include <iostream>
+#include <stdexcept>
+#include <algorithm>
+#include <utility>
+#include "nosuchobject.h"
+#include "memory.h"
+
+using namespace std;
+
+/* A Vector whose first INLINE elements are stored in the object itself, and
+ * which only moves them to a heap array once it outgrows them. As a BigInt
+ * container (BigInt<int,SmallVector>) the limbs of any value up to 128 bits
+ * sit inside the BigInt, so making, copying and destroying such values
+ * never allocates. Like Vector, the elements are contiguous, and an
+ * Iterator is a plain pointer.
+ */
+
+//elements kept in the object, so that they take about 24 bytes (at least 128 bits and a limb to spare)
+template <typename T>
+constexpr size_t smallVectorInline() noexcept{
+	return (sizeof(T) < 24? 24 / sizeof(T): 1);
+}
+
+template <typename T, size_t INLINE>
+class BasicSmallVector;
+
+template <typename T, size_t INLINE>
+ostream& operator<<(ostream &, const BasicSmallVector<T,INLINE>& );
+
+template <typename T, size_t INLINE>
+class BasicSmallVector{
+  friend ostream& operator<< <>(ostream&, const BasicSmallVector<T,INLINE>&);
+
+  public:
+	typedef T* Iterator;
+	BasicSmallVector() noexcept;
+	explicit BasicSmallVector(size_t count);
+	BasicSmallVector(size_t count, const T& value);
+	BasicSmallVector(const BasicSmallVector<T,INLINE> &other);
+	BasicSmallVector(BasicSmallVector<T,INLINE> &&other) noexcept;
+	~BasicSmallVector();
+	void clear() noexcept;
+	Iterator begin() const noexcept;
+	Iterator end() const noexcept;
+	Iterator prev(Iterator it) const;
+	T& operator[](size_t i) const;
+	T& front() const;
+	T& back() const;
+	const BasicSmallVector<T,INLINE>& operator=(const BasicSmallVector<T,INLINE> &other);
+	const BasicSmallVector<T,INLINE>& operator=(BasicSmallVector<T,INLINE> &&other) noexcept;
+	void push_back(const T& value);
+	void pop_back();
+	void reserve(size_t capacity);
+	size_t size() const noexcept;
+	size_t capacity() const noexcept;
+	bool empty() const noexcept;
+	bool isInline() const noexcept;
+	void printSmallVector() const noexcept;
+
+  private:
+	T *contents; //'local', or a heap array of 'cap' elements
+	size_t sz;
+	size_t cap;
+	T local[INLINE];
+	void reallocate(size_t capacity);
+	void release() noexcept;
+}; // BasicSmallVector class
+
+//one parameter, so that it matches BigInt's template <typename> typename C without C++17 rules
+template <typename T>
+using SmallVector = BasicSmallVector<T, smallVectorInline<T>()>;
+
+///////////////////////// FRIEND FUNCTIONS ///////////////////////////////
+
+template <typename T, size_t INLINE>
+ostream& operator<<(ostream &out, const BasicSmallVector<T,INLINE> &vector){
+	for(auto current:vector)
+		out << current;
+	return out;
+}
+
+///////////////////////// PRIVATE METHODS ////////////////////////////////
+
+//moves the elements into a heap array of 'capacity' elements, which has to be at least sz
+template <typename T, size_t INLINE>
+void BasicSmallVector<T,INLINE>::reallocate(size_t capacity){
+	T *newContents = memoryNewArray<T>(MEMORY_SMALL_VECTOR, capacity);
+	for(size_t i = 0; i < sz; i++)
+		newContents[i] = std::move(contents[i]);
+	release();
+	contents = newContents;
+	cap = capacity;
+}
+
+//frees the heap array, if there is one
+template <typename T, size_t INLINE>
+void BasicSmallVector<T,INLINE>::release() noexcept{
+	if(contents != local)
+		memoryDeleteArray(MEMORY_SMALL_VECTOR, contents, cap);
+	contents = local;
+	cap = INLINE;
+}
+
+///////////////////////// PUBLIC METHODS ////////////////////////////////
+
+template <typename T, size_t INLINE>
+BasicSmallVector<T,INLINE>::BasicSmallVector() noexcept:contents{local},sz{0},cap{INLINE}{}
+
+template <typename T, size_t INLINE>
+BasicSmallVector<T,INLINE>::BasicSmallVector(size_t count):BasicSmallVector(){
+	if(count > INLINE)
+		reallocate(count);
+	sz = count;
+}
+
+template <typename T, size_t INLINE>
+BasicSmallVector<T,INLINE>::BasicSmallVector(size_t count, const T& value):BasicSmallVector(count){
+	std::fill(contents, contents + sz, value);
+}
+
+template <typename T, size_t INLINE>
+BasicSmallVector<T,INLINE>::BasicSmallVector(const BasicSmallVector<T,INLINE> &other):BasicSmallVector(){
+	*this = other;
+}
+
+//move constructor, a heap array is taken over, inline elements are moved one by one
+template <typename T, size_t INLINE>
+BasicSmallVector<T,INLINE>::BasicSmallVector(BasicSmallVector<T,INLINE> &&other) noexcept:BasicSmallVector(){
+	*this = std::move(other);
+}
+
+template <typename T, size_t INLINE>
+BasicSmallVector<T,INLINE>::~BasicSmallVector(){
+	release();
+}
+
+//keeps the heap array, if there is one
+template <typename T, size_t INLINE>
+void BasicSmallVector<T,INLINE>::clear() noexcept{
+	sz = 0;
+}
+
+template <typename T, size_t INLINE>
+typename BasicSmallVector<T,INLINE>::Iterator BasicSmallVector<T,INLINE>::begin() const noexcept{
+	return contents;
+}
+
+template <typename T, size_t INLINE>
+typename BasicSmallVector<T,INLINE>::Iterator BasicSmallVector<T,INLINE>::end() const noexcept{
+	return contents + sz;
+}
+
+template <typename T, size_t INLINE>
+typename BasicSmallVector<T,INLINE>::Iterator BasicSmallVector<T,INLINE>::prev(Iterator it) const{
+	return --it;
+}
+
+template <typename T, size_t INLINE>
+T& BasicSmallVector<T,INLINE>::operator[](size_t i) const{
+	if(i >= sz)
+		throw out_of_range("SmallVector::operator[]: error! tried access invalid index");
+	return contents[i];
+}
+
+template <typename T, size_t INLINE>
+T& BasicSmallVector<T,INLINE>::front() const{
+	if(sz == 0)
+		throw NoSuchObject("SmallVector::front: error! tried accessing an empty vector");
+	return contents[0];
+}
+
+template <typename T, size_t INLINE>
+T& BasicSmallVector<T,INLINE>::back() const{
+	if(sz == 0)
+		throw NoSuchObject("SmallVector::back: error! tried accessing an empty vector");
+	return contents[sz-1];
+}
+
+//the elements go inline when they fit, otherwise into the existing heap array if it is large enough
+template <typename T, size_t INLINE>
+const BasicSmallVector<T,INLINE>& BasicSmallVector<T,INLINE>::operator=(const BasicSmallVector<T,INLINE> &other){
+	if(&other != this){
+		sz = 0;
+		if(other.sz <= INLINE)
+			release();
+		else if(cap < other.sz)
+			reallocate(other.sz);
+		std::copy(other.contents, other.contents + other.sz, contents);
+		sz = other.sz;
+	}
+	return *this;
+}
+
+template <typename T, size_t INLINE>
+const BasicSmallVector<T,INLINE>& BasicSmallVector<T,INLINE>::operator=(BasicSmallVector<T,INLINE> &&other) noexcept{
+	if(&other != this){
+		release();
+		if(other.contents == other.local){
+			for(size_t i = 0; i < other.sz; i++)
+				local[i] = std::move(other.local[i]);
+		}
+		else{
+			contents = other.contents;
+			cap = other.cap;
+			other.contents = other.local;
+			other.cap = INLINE;
+		}
+		sz = other.sz;
+		other.sz = 0;
+	}
+	return *this;
+}
+
+template <typename T, size_t INLINE>
+void BasicSmallVector<T,INLINE>::push_back(const T& value){
+	if(sz == cap)
+		reallocate(2 * cap);
+	contents[sz++] = value;
+}
+
+template <typename T, size_t INLINE>
+void BasicSmallVector<T,INLINE>::pop_back(){
+	if(sz == 0)
+		throw NoSuchObject("SmallVector::pop_back: error! tried popping an empty vector");
+	--sz;
+}
+
+//makes room for at least 'capacity' elements, so that pushing that many doesn't reallocate
+template <typename T, size_t INLINE>
+void BasicSmallVector<T,INLINE>::reserve(size_t capacity){
+	if(capacity > cap)
+		reallocate(capacity);
+}
+
+template <typename T, size_t INLINE>
+size_t BasicSmallVector<T,INLINE>::size() const noexcept{
+	return sz;
+}
+
+template <typename T, size_t INLINE>
+size_t BasicSmallVector<T,INLINE>::capacity() const noexcept{
+	return cap;
+}
+
+template <typename T, size_t INLINE>
+bool BasicSmallVector<T,INLINE>::empty() const noexcept{
+	return sz == 0;
+}
+
+//whether the elements are still stored in the object itself
+template <typename T, size_t INLINE>
+bool BasicSmallVector<T,INLINE>::isInline() const noexcept{
+	return contents == local;
+}
+
+template <typename T, size_t INLINE>
+void BasicSmallVector<T,INLINE>::printSmallVector() const noexcept{
+	for(auto current:*this)
+		cout << current << " ";
+}
+
+#endif
@@ -0,0 +1,210 @@
+#ifndef STATS_H
+#define STATS_H
+
+#include <cstddef>
+#include "memory.h"
+
+/* Opt-in instrumentation of the BigInt hot paths. It is built in with
+ * -DBIGINT_STATS, and compiled out entirely otherwise: the macros below
+ * expand to nothing, and the rest of this file is left out.
+ *
+ * Every instrumented operation (see StatOp) counts its calls, the limbs of
+ * its operands, and the allocations the containers made while it ran, with
+ * their bytes (see memory.h). It also keeps the bytes its calls left
+ * allocated (live), the most any one call held on top of what was there
+ * before (peak), its total latency, and a histogram of that in
+ * power of 2 buckets: bucket k counts the calls that took [2^k, 2^(k+1))
+ * nanoseconds. An operation that runs inside another (addHelper inside
+ * operator+) counts for both. The counters are shared by all threads.
+ *
+ * statsOf() reads the counters of one operation, writeStatsJson() writes
+ * all of them, and statsReset() starts over. At exit the JSON is written to
+ * the file named by the environment variable BIGINT_STATS_FILE ('-' for
+ * stderr), if it is set.
+ */
+
+#ifdef BIGINT_STATS
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <fstream>
+#include <cstring>
+
+using namespace std;
+
+enum StatOp{
+	STAT_ADD, //operator+
+	STAT_SUB, //operator-
+	STAT_MUL, //operator*
+	STAT_DIVMOD, //divmod, and so operator/ and operator%
+	STAT_ACCUMULATE, //operator+= and operator-=
+	STAT_ADD_HELPER_SUM, //addHelper code 1
+	STAT_ADD_HELPER_DIFFERENCE, //addHelper code 2
+	STAT_COMPARE, //compare, ==, !=, <, >, <= and >=
+	STAT_PARSE,
+	STAT_READ, //operator>>
+	STAT_WRITE, //operator<<
+	STAT_OPS
+};
+
+const char *const STAT_NAMES[STAT_OPS] = {"operator+", "operator-", "operator*", "divmod", "operator+=/-=",
+										  "addHelper(1)", "addHelper(2)", "compare", "parse", "operator>>",
+										  "operator<<"};
+
+const size_t STAT_BUCKETS = 48; //the last one also takes anything slower than 2^48 ns
+
+struct OpStats{
+	atomic<uint64_t> calls;
+	atomic<uint64_t> limbs;
+	atomic<uint64_t> allocations;
+	atomic<uint64_t> bytes;
+	atomic<int64_t> liveBytes;
+	atomic<int64_t> peakBytes;
+	atomic<uint64_t> nanoseconds;
+	atomic<uint64_t> latency[STAT_BUCKETS];
+};
+
+//the counters of one operation at one point in time
+struct OpStatsSnapshot{
+	uint64_t calls;
+	uint64_t limbs;
+	uint64_t allocations;
+	uint64_t bytes;
+	int64_t liveBytes;
+	int64_t peakBytes;
+	uint64_t nanoseconds;
+	uint64_t latency[STAT_BUCKETS];
+};
+
+void writeStatsJson(ostream &out);
+
+//writes the JSON to BIGINT_STATS_FILE, if it is set
+inline void dumpStatsAtExit(){
+	const char *path = getenv("BIGINT_STATS_FILE");
+	if(path == nullptr)
+		return;
+	if(strcmp(path, "-") == 0){
+		writeStatsJson(cerr);
+		return;
+	}
+	ofstream out(path);
+	if(out.is_open())
+		writeStatsJson(out);
+}
+
+//the counters of every operation; the first call arranges for the dump at exit
+inline OpStats* statsTable() noexcept{
+	static OpStats table[STAT_OPS]; //zero initialized, like any static
+	static bool registered = (atexit(dumpStatsAtExit) == 0);
+	(void)registered;
+	return table;
+}
+
+//counts one call of an operation, from its construction to its destruction
+class StatScope{
+  public:
+	StatScope(StatOp op, size_t limbs) noexcept;
+	StatScope(const StatScope&) = delete;
+	StatScope& operator=(const StatScope&) = delete;
+	~StatScope();
+	void addLimbs(size_t limbs) noexcept;
+
+  private:
+	StatOp op;
+	MemoryThread before; //the counters of the thread when the call started
+	chrono::steady_clock::time_point start;
+};
+
+//the peak of the thread starts over from its live bytes, and is put back in the destructor
+inline StatScope::StatScope(StatOp op, size_t limbs) noexcept
+	:op{op},before(memoryThread()),start{chrono::steady_clock::now()}{
+	memoryThread().peak = before.live;
+	addLimbs(limbs);
+}
+
+inline StatScope::~StatScope(){
+	uint64_t elapsed = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start).count();
+	OpStats &stats = statsTable()[op];
+	MemoryThread &after = memoryThread();
+	stats.calls.fetch_add(1, memory_order_relaxed);
+	stats.allocations.fetch_add(after.allocations - before.allocations, memory_order_relaxed);
+	stats.bytes.fetch_add(after.bytes - before.bytes, memory_order_relaxed);
+	stats.liveBytes.fetch_add(after.live - before.live, memory_order_relaxed);
+	memoryRaise(stats.peakBytes, after.peak - before.live);
+	if(before.peak > after.peak) //an enclosing call's peak may be higher
+		after.peak = before.peak;
+	stats.nanoseconds.fetch_add(elapsed, memory_order_relaxed);
+	size_t bucket = (elapsed == 0? 0: 63 - __builtin_clzll(elapsed));
+	stats.latency[bucket < STAT_BUCKETS? bucket: STAT_BUCKETS - 1].fetch_add(1, memory_order_relaxed);
+}
+
+//for operations that only know their limbs once they are done, like parse
+inline void StatScope::addLimbs(size_t limbs) noexcept{
+	statsTable()[op].limbs.fetch_add(limbs, memory_order_relaxed);
+}
+
+inline OpStatsSnapshot statsOf(StatOp op) noexcept{
+	const OpStats &stats = statsTable()[op];
+	OpStatsSnapshot snapshot;
+	snapshot.calls = stats.calls.load(memory_order_relaxed);
+	snapshot.limbs = stats.limbs.load(memory_order_relaxed);
+	snapshot.allocations = stats.allocations.load(memory_order_relaxed);
+	snapshot.bytes = stats.bytes.load(memory_order_relaxed);
+	snapshot.liveBytes = stats.liveBytes.load(memory_order_relaxed);
+	snapshot.peakBytes = stats.peakBytes.load(memory_order_relaxed);
+	snapshot.nanoseconds = stats.nanoseconds.load(memory_order_relaxed);
+	for(size_t k = 0; k < STAT_BUCKETS; k++)
+		snapshot.latency[k] = stats.latency[k].load(memory_order_relaxed);
+	return snapshot;
+}
+
+inline void statsReset() noexcept{
+	OpStats *table = statsTable();
+	for(size_t op = 0; op < STAT_OPS; op++){
+		table[op].calls = 0;
+		table[op].limbs = 0;
+		table[op].allocations = 0;
+		table[op].bytes = 0;
+		table[op].liveBytes = 0;
+		table[op].peakBytes = 0;
+		table[op].nanoseconds = 0;
+		for(size_t k = 0; k < STAT_BUCKETS; k++)
+			table[op].latency[k] = 0;
+	}
+}
+
+//one object per operation; the histogram maps the lower bound of each nonempty bucket (in ns) to its calls
+inline void writeStatsJson(ostream &out){
+	out << "{\n";
+	for(size_t op = 0; op < STAT_OPS; op++){
+		OpStatsSnapshot stats = statsOf(static_cast<StatOp>(op));
+		out << "  \"" << STAT_NAMES[op] << "\": {\"calls\": " << stats.calls << ", \"limbs\": " << stats.limbs
+			<< ", \"allocations\": " << stats.allocations << ", \"bytes\": " << stats.bytes
+			<< ", \"live_bytes\": " << stats.liveBytes << ", \"peak_bytes\": " << stats.peakBytes
+			<< ", \"nanoseconds\": " << stats.nanoseconds << ", \"latency\": {";
+		const char *separator = "";
+		for(size_t k = 0; k < STAT_BUCKETS; k++){
+			if(stats.latency[k] == 0)
+				continue;
+			out << separator << "\"" << (uint64_t(1) << k) << "\": " << stats.latency[k];
+			separator = ", ";
+		}
+		out << "}}" << (op + 1 < STAT_OPS? ",": "") << "\n";
+	}
+	out << "}\n";
+}
+
+#define BIGINT_STAT_SCOPE(op, limbs) StatScope statScope((op), (limbs))
+#define BIGINT_STAT_LIMBS(limbs) statScope.addLimbs(limbs)
+
+#else
+
+#define BIGINT_STAT_SCOPE(op, limbs) ((void)0)
+#define BIGINT_STAT_LIMBS(limbs) ((void)0)
+
+#endif
+
+#endif
@@ -0,0 +1,244 @@
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <cstddef>
+#include <atomic>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <utility>
+#include "vector.h"
+#include "memory.h"
+
+using namespace std;
+
+/* A work stealing thread pool. Every worker has its own queue of tasks: it
+ * takes the newest task of its own queue (which keeps its caches warm), and
+ * when that is empty it steals the oldest task of another worker's queue.
+ * Tasks submitted from outside the pool are dealt out to the workers in turn.
+ *
+ * Tasks belong to a TaskGroup, and wait(group) returns once all of them have
+ * run, rethrowing the first exception any of them threw. A thread waiting on
+ * a group runs queued tasks in the meantime (a worker keeps doing so until
+ * the group is done, so tasks can themselves submit and wait for more tasks
+ * without running out of threads; any other thread sleeps once there is
+ * nothing left to run). A task runs with the MemoryBudget that was in scope
+ * where it was submitted, so its allocations count against it.
+ */
+
+class TaskGroup{
+  friend class ThreadPool;
+  public:
+	TaskGroup() noexcept;
+	TaskGroup(const TaskGroup&) = delete;
+	TaskGroup& operator=(const TaskGroup&) = delete;
+
+  private:
+	atomic<size_t> pending; //tasks submitted that haven't finished yet
+	mutex lock; //guards 'error', and the last task finishing
+	condition_variable done;
+	exception_ptr error; //the first exception a task threw
+};
+
+class ThreadPool{
+  public:
+	explicit ThreadPool(size_t threads = thread::hardware_concurrency());
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool& operator=(const ThreadPool&) = delete;
+	~ThreadPool();
+	size_t size() const noexcept;
+	void submit(TaskGroup &group, function<void()> task);
+	void wait(TaskGroup &group);
+	template <typename F>
+	void parallelFor(size_t first, size_t last, size_t grain, F body);
+
+  private:
+	struct Task{
+		function<void()> run;
+		TaskGroup *group;
+		MemoryBudget *budget; //in scope where the task was submitted
+	};
+	struct Worker{
+		deque<Task> tasks;
+		mutex lock;
+	};
+	Vector<Worker*> workers;
+	Vector<thread*> threads;
+	atomic<size_t> queued; //tasks in the queues, not started yet
+	atomic<size_t> nextWorker; //where the next task from outside the pool goes
+	atomic<bool> stopping;
+	mutex sleepLock;
+	condition_variable wake;
+	struct Identity{
+		const ThreadPool *pool;
+		int index;
+	};
+	static Identity& identity() noexcept;
+	int currentWorker() const noexcept;
+	bool runOne(int self);
+	void work(int self);
+};
+
+///////////////////////// TASK GROUP ////////////////////////////////////
+
+inline TaskGroup::TaskGroup() noexcept:pending{0}{}
+
+///////////////////////// PRIVATE METHODS ////////////////////////////////
+
+//the pool the calling thread works for, if any, and its index there
+inline ThreadPool::Identity& ThreadPool::identity() noexcept{
+	static thread_local Identity worker = {nullptr, -1};
+	return worker;
+}
+
+//the index of the calling thread among the workers, -1 if it isn't one of them
+inline int ThreadPool::currentWorker() const noexcept{
+	return (identity().pool == this? identity().index: -1);
+}
+
+//runs one queued task, preferring the newest one of worker 'self'; returns false if there was none
+inline bool ThreadPool::runOne(int self){
+	Task task;
+	bool found = false;
+	size_t n = workers.size();
+	if(self >= 0){
+		Worker &own = *workers[self];
+		lock_guard<mutex> guard(own.lock);
+		if(!own.tasks.empty()){
+			task = std::move(own.tasks.back());
+			own.tasks.pop_back();
+			found = true;
+		}
+	}
+	for(size_t k = 1; !found && k <= n; k++){ //steals the oldest task of another worker
+		Worker &victim = *workers[(self + k) % n];
+		lock_guard<mutex> guard(victim.lock);
+		if(!victim.tasks.empty()){
+			task = std::move(victim.tasks.front());
+			victim.tasks.pop_front();
+			found = true;
+		}
+	}
+	if(!found)
+		return false;
+	--queued;
+	exception_ptr error;
+	try{
+		MemoryBudgetScope scope(task.budget);
+		task.run();
+	}catch(...){
+		error = current_exception();
+	}
+	//the waiter takes the lock before it returns, so the group outlives this block
+	lock_guard<mutex> guard(task.group->lock);
+	if(error && !task.group->error)
+		task.group->error = error;
+	if(--task.group->pending == 0)
+		task.group->done.notify_all();
+	return true;
+}
+
+inline void ThreadPool::work(int self){
+	while(true){
+		if(runOne(self))
+			continue;
+		unique_lock<mutex> guard(sleepLock);
+		wake.wait(guard, [this]{ return stopping || queued > 0; });
+		if(stopping && queued == 0)
+			return;
+	}
+}
+
+///////////////////////// PUBLIC METHODS ////////////////////////////////
+
+inline ThreadPool::ThreadPool(size_t count):workers(0),threads(0),queued{0},nextWorker{0},stopping{false}{
+	if(count == 0)
+		count = 1;
+	for(size_t i = 0; i < count; i++)
+		workers.push_back(new Worker);
+	for(size_t i = 0; i < count; i++){
+		threads.push_back(new thread([this, i]{
+			identity() = {this, static_cast<int>(i)};
+			work(static_cast<int>(i));
+		}));
+	}
+}
+
+//runs the tasks still queued, then stops the workers
+inline ThreadPool::~ThreadPool(){
+	{
+		lock_guard<mutex> guard(sleepLock);
+		stopping = true;
+	}
+	wake.notify_all();
+	for(size_t i = 0; i < threads.size(); i++){
+		threads[i]->join();
+		delete threads[i];
+	}
+	for(size_t i = 0; i < workers.size(); i++) //the last worker to stop may still be stealing from the others
+		delete workers[i];
+}
+
+inline size_t ThreadPool::size() const noexcept{
+	return workers.size();
+}
+
+//queues 'task' as part of 'group': on the calling worker's own queue, or the next worker's in turn
+inline void ThreadPool::submit(TaskGroup &group, function<void()> task){
+	++group.pending;
+	int self = currentWorker();
+	size_t target = (self >= 0? size_t(self): nextWorker++ % workers.size());
+	{
+		lock_guard<mutex> guard(workers[target]->lock);
+		workers[target]->tasks.push_back({std::move(task), &group, MemoryBudget::current()});
+	}
+	++queued;
+	{
+		lock_guard<mutex> guard(sleepLock); //a worker that is about to sleep sees the task, or the wakeup
+	}
+	wake.notify_one();
+}
+
+//returns once every task of 'group' has run, running queued tasks meanwhile
+inline void ThreadPool::wait(TaskGroup &group){
+	int self = currentWorker();
+	while(group.pending > 0){
+		if(runOne(self))
+			continue;
+		if(self >= 0) //a worker that sleeps here might be the one the group waits for
+			this_thread::yield();
+		else{
+			unique_lock<mutex> guard(group.lock);
+			group.done.wait(guard, [&group]{ return group.pending == 0; });
+		}
+	}
+	lock_guard<mutex> guard(group.lock);
+	if(group.error){
+		exception_ptr error = group.error;
+		group.error = nullptr;
+		rethrow_exception(error);
+	}
+}
+
+//calls body(from, to) for consecutive ranges of at most 'grain' indices covering [first, last), in parallel
+template <typename F>
+void ThreadPool::parallelFor(size_t first, size_t last, size_t grain, F body){
+	if(grain == 0)
+		grain = 1;
+	if(last - first <= grain){ //nothing to split
+		if(first < last)
+			body(first, last);
+		return;
+	}
+	TaskGroup group;
+	for(size_t from = first; from < last; from += grain){
+		size_t to = (last - from > grain? from + grain: last);
+		submit(group, [&body, from, to]{ body(from, to); });
+	}
+	wait(group);
+}
+
+#endif
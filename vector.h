@@ -4,7 +4,9 @@
 #include <iostream>
 #include <stdexcept>
 #include <new>
+#include <utility>
 #include "nosuchobject.h"
+#include "memory.h"
 
 using namespace std;
 
@@ -28,6 +30,7 @@ class Vector {
 	Vector(const size_t count);
 	Vector(const size_t count, const T& value);
 	Vector(const Vector<T>& other);
+	Vector(Vector<T>&& other) noexcept;
 	Vector(initializer_list<T> init); 
 	~Vector();
 	void clear();
@@ -45,10 +48,14 @@ class Vector {
 	const T& front() const;
 	const T& back() const;
 	const Vector<T>& operator=(const Vector<T>& other);
+	const Vector<T>& operator=(Vector<T>&& other) noexcept;
 	const Vector<T>& operator=(initializer_list<T> ilist);
 	void push_back(const T& value);
 	void pop_back();
+	void reserve(size_t capacity);
+	void shrink_to_fit();
 	size_t size() const noexcept;
+	size_t capacity() const noexcept;
 	bool empty() const noexcept;
 	void printVector() const noexcept;
 
@@ -57,6 +64,7 @@ class Vector {
 	size_t sz;
 	size_t cap;
 	void increaseCapacity();
+	void reallocate(size_t capacity);
 }; // Vector<T> class
 
 ///////////////////// FRIEND FUNCTIONS /////////////////////////////
@@ -71,23 +79,28 @@ ostream& operator<<(ostream &out, const Vector<T> &vector){
 ///////////////////// PRIVATE METHODS //////////////////////////////
 template <typename T>
 void Vector<T>::increaseCapacity(){
-	cap *= 2;
-	T *newContents = new T[cap];
-	for(unsigned i=0; i<sz; i++)
-		newContents[i] = contents[i];
-	delete[] contents;
+	reallocate(cap > 0? cap * 2: 10); //a moved-from or 0-sized vector has no capacity
+}
+
+//moves the elements into a new array of 'capacity' elements, which has to be at least sz
+template <typename T>
+void Vector<T>::reallocate(size_t capacity){
+	T *newContents = memoryNewArray<T>(MEMORY_VECTOR, capacity);
+	for(size_t i=0; i<sz; i++)
+		newContents[i] = std::move(contents[i]);
+	memoryDeleteArray(MEMORY_VECTOR, contents, cap);
 	contents = newContents;
+	cap = capacity;
 }
 
 // PUBLIC METHODS /////////////////////////
+//an empty vector allocates nothing, its first push_back does
 template <typename T>
-Vector<T>::Vector():sz{0},cap{10}{
-	contents = new T[cap];
-}
+Vector<T>::Vector():contents{nullptr},sz{0},cap{0}{}
 
 template <typename T>
 Vector<T>::Vector(const size_t count):sz{count},cap{count}{
-	contents = new T[cap];	
+	contents = (cap > 0? memoryNewArray<T>(MEMORY_VECTOR, cap): nullptr);
 }
 
 template <typename T>
@@ -101,9 +114,17 @@ Vector<T>::Vector(const Vector<T>& other):contents{0},sz{0},cap{0}{
 	*this = other;
 }
 
+//move constructor, 'other' is left empty without any capacity
+template <typename T>
+Vector<T>::Vector(Vector<T>&& other) noexcept:contents{other.contents},sz{other.sz},cap{other.cap}{
+	other.contents = nullptr;
+	other.sz = 0;
+	other.cap = 0;
+}
+
 template <typename T>
 Vector<T>::Vector(initializer_list<T> init):cap{init.size()}{
-	contents = new T[cap];
+	contents = memoryNewArray<T>(MEMORY_VECTOR, cap);
 	sz = 0;
 	for(T object: init){
 		push_back(object);
@@ -112,7 +133,7 @@ Vector<T>::Vector(initializer_list<T> init):cap{init.size()}{
 
 template <typename T>
 Vector<T>::~Vector(){
-	delete[] contents;
+	memoryDeleteArray(MEMORY_VECTOR, contents, cap);
 }
 
 template <typename T>
@@ -138,7 +159,7 @@ typename Vector<T>::Iterator Vector<T>::atPosition(size_t index) const{
 
 template <typename T>
 typename Vector<T>::Iterator Vector<T>::begin() const noexcept{
-	return &contents[0];	
+	return contents;
 }
 
 template <typename T>
@@ -148,7 +169,7 @@ typename Vector<T>::Iterator Vector<T>::prev(Iterator it) const{
 
 template <typename T>
 typename Vector<T>::Iterator Vector<T>::end() const  noexcept{
-	return &contents[sz];	
+	return contents + sz;
 }
 
 template <typename T>
@@ -297,14 +318,17 @@ const T& Vector<T>::back() const{
 	return contents[sz-1];
 }
 
+//the existing array is kept if it is large enough, otherwise one of exactly other.sz elements is made
 template <typename T>
 const Vector<T>& Vector<T>::operator=(const Vector<T>& other){
 	if(&other != this){
 		if(!empty()) clear();
-		if(cap!=other.cap){
-			delete[] contents;
-			cap = other.cap;
-			contents = new T[cap];
+		if(cap < other.sz){
+			memoryDeleteArray(MEMORY_VECTOR, contents, cap);
+			contents = nullptr; //stays valid if 'new' throws
+			cap = 0;
+			contents = memoryNewArray<T>(MEMORY_VECTOR, other.sz);
+			cap = other.sz;
 		}
 		sz = other.sz;
 		for(unsigned i=0; i<sz; i++)
@@ -313,10 +337,27 @@ const Vector<T>& Vector<T>::operator=(const Vector<T>& other){
 	return *this;
 }
 
+template <typename T>
+const Vector<T>& Vector<T>::operator=(Vector<T>&& other) noexcept{
+	if(&other != this){
+		memoryDeleteArray(MEMORY_VECTOR, contents, cap);
+		contents = other.contents;
+		sz = other.sz;
+		cap = other.cap;
+		other.contents = nullptr;
+		other.sz = 0;
+		other.cap = 0;
+	}
+	return *this;
+}
+
 template <typename T>
 const Vector<T>& Vector<T>::operator=(initializer_list<T> ilist){
-	delete[] contents;
-	contents = new T[ilist.size()];
+	memoryDeleteArray(MEMORY_VECTOR, contents, cap);
+	contents = nullptr; //stays valid if 'new' throws
+	cap = 0;
+	contents = memoryNewArray<T>(MEMORY_VECTOR, ilist.size());
+	cap = ilist.size();
 	sz = 0;
 	for(T object: ilist)
 		push_back(object);
@@ -338,11 +379,30 @@ void Vector<T>::pop_back(){
 		throw NoSuchObject("Vector::pop_back: error! tried popping an empty vector");
 }
 
+//makes room for at least 'capacity' elements, so that pushing that many doesn't reallocate
+template <typename T>
+void Vector<T>::reserve(size_t capacity){
+	if(capacity > cap)
+		reallocate(capacity);
+}
+
+//drops the capacity that isn't used
+template <typename T>
+void Vector<T>::shrink_to_fit(){
+	if(cap > sz && contents != nullptr)
+		reallocate(sz);
+}
+
 template <typename T>
 size_t Vector<T>::size() const noexcept{
 	return sz;
 }
 
+template <typename T>
+size_t Vector<T>::capacity() const noexcept{
+	return cap;
+}
+
 template <typename T>
 void Vector<T>::printVector() const noexcept{
 	for(auto current:*this)